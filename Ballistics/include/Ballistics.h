@@ -1,4 +1,6 @@
 #pragma once
+#include <functional>
+#include <span>
 #include <vector>
 #include <Algebra.h>
 #include "BulletData.h"
@@ -16,6 +18,7 @@ namespace Ballistics
 	 * This structure contains essential environmental properties such as temperature, gravity,
 	 * air density, and air pressure. It also provides functionality to update the air density
 	 * based on the current temperature and pressure values using the ideal gas law approximation.
+	 * The solvers take 1/speed of sound from TKelvin once at setup, so that they convert speed to Mach with a multiply.
 	 */
 	struct EnvironmentData
 	{
@@ -23,11 +26,21 @@ namespace Ballistics
 		float	Gravity;
 		float	AirDensity;
 		float	AirPressure;
+		// 3D solver only; wind velocity in the firing frame, X downrange, Y up and Z to the right of the line of fire
+		Algebra::Vector3D WindMs{};
+		// 3D solver only, for Coriolis
+		float	LatitudeRad = 0.0f;
 
 		constexpr void UpdateAirDensityFromTandP()
 		{
 			AirDensity = AirPressure / (287.05f * TKelvin);
 		}
+
+		// always from the current TKelvin, there is nothing cached to go stale
+		float GetInvSpeedOfSound() const
+		{
+			return 1.0f / GetSpeedOfSound(TKelvin);
+		}
 	};
 
 	constexpr float KelvinToCelcius(float TK)
@@ -35,6 +48,34 @@ namespace Ballistics
 		return TK - 272.15f;
 	}
 
+	enum class ZeroingMethod
+	{
+		// bisect the launch angle between 0 and pi/2
+		Bisection,
+		// secant iteration on the same residual, from a small angle initial guess, bisecting if it stops converging
+		Secant,
+	};
+
+	struct ZeroingParams
+	{
+		ZeroingMethod Method = ZeroingMethod::Bisection;
+		// each iteration is one trial trajectory
+		int MaxIterations = 50;
+		float TimeStep = 0.01f;
+		float MaxTime = 10.0f;
+	};
+
+	struct ZeroingResult
+	{
+		bool bConverged = false;
+		// trial trajectories integrated
+		int Iterations = 0;
+		// integrator steps over all trials
+		size_t SolverSteps = 0;
+		// height relative to the line of sight at the zero distance for the final angle
+		float ResidualM = 0.0f;
+	};
+
 	/**
 	 * @brief Represents the configuration and parameters required for firing calculations.
 	 *
@@ -49,15 +90,51 @@ namespace Ballistics
 		float	ZeroDistance = 0.0f;
 		float	ZeroAngle = 0.0f;
 		float	Height = 0.0f;
+		// 3D solver only; direction of fire clockwise from north, for Coriolis
+		float	AzimuthRad = 0.0f;
+		// 3D solver only; gyroscopic stability factor Sg for the empirical spin drift, 0 for none
+		float	SpinStability = 0.0f;
+		bool	bLeftHandTwist = false;
 
-		void ZeroIn(const DragTableType& InDragTable, float ToleranceMm, const EnvironmentData& Environment);
+		/**
+		 * Find the ZeroAngle for which the trajectory crosses the line of sight at ZeroDistance, to within ToleranceM.
+		 * If the zeroing doesn't converge within Params.MaxIterations the best angle found is kept and the result says so.
+		 */
+		ZeroingResult ZeroIn(const DragTableType& InDragTable, float ToleranceM, const EnvironmentData& Environment, const ZeroingParams& Params = {});
+		ZeroingResult ZeroIn(const CompiledDragTable& InDragTable, float ToleranceM, const EnvironmentData& Environment, const ZeroingParams& Params = {});
+	};
+
+	enum class IntegratorType
+	{
+		// fixed TimeStep, RK4 on flight speed re-projected on the direction of flight
+		HybridEulerRk4,
+		// point mass model, adaptive step Dormand-Prince 5(4) with error control
+		DormandPrince45,
+		// 3-DOF point mass model with wind, Coriolis and spin drift, fixed TimeStep RK4
+		PointMass3D,
 	};
 
 	struct SolverParams
 	{
+		// fixed step, or the initial step for adaptive integrators
 		float TimeStep = 0.0f;
 		float MaxTime = 0.0f;
 		float MaxX = 0.0f;
+		// the trajectory ends when it drops below this height, i.e. hits the ground by default
+		float MinY = 0.0f;
+
+		IntegratorType Integrator = IntegratorType::HybridEulerRk4;
+		// adaptive integrators only; relative error per step and step size limits
+		float Tolerance = 1e-6f;
+		float MinTimeStep = 1e-4f;
+		float MaxTimeStep = 0.1f;
+		// if non-zero output is sampled every OutputDistanceStep metres instead of once per step, interpolated within
+		// the step; linearly for fixed step integrators and with the dense output of adaptive integrators
+		float OutputDistanceStep = 0.0f;
+		// when not sampling by distance, output every OutputStepStride'th step only
+		size_t OutputStepStride = 1;
+		// 3D solver only; include the Coriolis acceleration from EnvironmentData::LatitudeRad and FiringData::AzimuthRad
+		bool bCoriolis = false;
 	};
 
 	/**
@@ -66,6 +143,7 @@ namespace Ballistics
 	 * This structure captures the state of a projectile at a given time during its flight.
 	 * It includes information such as the current velocity components, the distances traveled
 	 * in both horizontal and vertical directions, and the elapsed time.
+	 * The lateral drift, to the right of the line of fire, is only non-zero for the 3D solver.
 	 * The structure also provides functionality to initialize its state based on input firing data.
 	 */
 	struct TrajectoryDataPoint
@@ -73,6 +151,8 @@ namespace Ballistics
 		Algebra::Vector2D Velocity;
 		Algebra::Vector2D Position;
 		float T;
+		float Drift = 0.0f;
+		float DriftVelocity = 0.0f;
 
 		constexpr TrajectoryDataPoint() = default;
 		explicit TrajectoryDataPoint(FiringData InFiringData)
@@ -83,6 +163,7 @@ namespace Ballistics
 		constexpr TrajectoryDataPoint& Initialize(FiringData InFiringData)
 		{
 			T = 0.0f;
+			Drift = DriftVelocity = 0.0f;
 			Position.SetX(0.0f);
 			Position.SetY(InFiringData.Height);
 			Velocity.SetX(InFiringData.MuzzleVelocityMs * cosf(InFiringData.ZeroAngle));
@@ -100,4 +181,38 @@ namespace Ballistics
 	 * @param Solver 
 	 */
 	void SolveTrajectory(const DragTableType& InDragTable, std::vector<TrajectoryDataPoint>& OutTrajectoryDataPoints, const FiringData & InFiringData, const EnvironmentData & Environment, const SolverParams & Solver);
+
+	/**
+	 * Calculate trajectory of projectile using a compiled drag table, prefer this when solving many trajectories
+	 */
+	void SolveTrajectory(const CompiledDragTable& InDragTable, std::vector<TrajectoryDataPoint>& OutTrajectoryDataPoints, const FiringData & InFiringData, const EnvironmentData & Environment, const SolverParams & Solver);
+
+	/**
+	 * Calculate trajectory of projectile into a caller supplied buffer, without allocating.
+	 * The integration stops when the buffer is full.
+	 * @return the number of points written
+	 */
+	size_t SolveTrajectory(const DragTableType& InDragTable, std::span<TrajectoryDataPoint> OutTrajectoryDataPoints, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& Solver);
+	size_t SolveTrajectory(const CompiledDragTable& InDragTable, std::span<TrajectoryDataPoint> OutTrajectoryDataPoints, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& Solver);
+
+	// receives trajectory points as they are produced, returning false stops the integration
+	using TrajectorySink = std::function<bool(const TrajectoryDataPoint&)>;
+
+	/**
+	 * Calculate trajectory of projectile, streaming the points to Sink instead of storing them
+	 */
+	void SolveTrajectory(const DragTableType& InDragTable, const TrajectorySink& Sink, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& Solver);
+	void SolveTrajectory(const CompiledDragTable& InDragTable, const TrajectorySink& Sink, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& Solver);
+
+	/**
+	 * Calculate a batch of trajectories in lock-step, equivalent to calling SolveTrajectory once per firing data entry.
+	 *
+	 * The lane state is kept as structure-of-arrays and every step advances all lanes together; lanes that hit the ground,
+	 * MaxX or MaxTime are masked out until the whole batch has completed. Output is decimated by OutputStepStride,
+	 * OutputDistanceStep is not supported.
+	 * @param OutTrajectories one vector per lane, points are appended as for SolveTrajectory
+	 * @param InFiringData one entry per lane
+	 * @param InEnvironments one entry per lane, or a single entry shared by all lanes
+	 */
+	void SolveTrajectoryBatch(const CompiledDragTable& InDragTable, std::span<std::vector<TrajectoryDataPoint>> OutTrajectories, std::span<const FiringData> InFiringData, std::span<const EnvironmentData> InEnvironments, const SolverParams& Solver);
 }
\ No newline at end of file
@@ -0,0 +1,187 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "BulletData.h"
+#include "FlatArray.h"
+
+namespace Ballistics
+{
+    /**
+     * @brief Stores each distinct string once, contiguously, and identifies it by a dense index.
+     *
+     * Catalogue strings repeat heavily (a handful of companies and product names over thousands of bullets), so the
+     * bullets hold 32 bit ids instead of std::strings. Lookup is an open addressing hash table of ids, compared
+     * against the stored text, so the whole pool is three flat arrays and can be viewed in a snapshot as it is.
+     */
+    class StringPool
+    {
+    public:
+        // FNV-1a, the same on every platform as the hash table is part of the snapshot format
+        static uint64_t Hash(std::string_view String);
+
+        uint32_t Intern(std::string_view String);
+
+        // the id of String if it has been interned
+        bool Find(std::string_view String, uint32_t& OutId) const;
+
+        std::string_view Get(uint32_t Id) const
+        {
+            return std::string_view(Chars.data() + Offsets[Id], Offsets[Id + 1] - Offsets[Id]);
+        }
+
+        size_t Size() const
+        {
+            return Offsets.size() - 1;
+        }
+
+        void Clear();
+
+    private:
+        friend class SnapshotSerializer;
+
+        void Rehash(size_t NumBuckets);
+
+        FlatArray<char> Chars;
+        // string n is Chars[Offsets[n], Offsets[n+1])
+        FlatArray<uint32_t> Offsets = std::vector<uint32_t>{0};
+        // power of two sized, Id+1 or 0 for an empty bucket, at most half full
+        FlatArray<uint32_t> Buckets;
+    };
+
+    // inclusive range, unbounded by default
+    struct FloatRange
+    {
+        float Min = std::numeric_limits<float>::lowest();
+        float Max = std::numeric_limits<float>::max();
+
+        bool Contains(float Value) const
+        {
+            return Value >= Min && Value <= Max;
+        }
+
+        bool IsBounded() const
+        {
+            return Min != std::numeric_limits<float>::lowest() || Max != std::numeric_limits<float>::max();
+        }
+    };
+
+    /**
+     * @brief All bullets matching every field, e.g. {.CallibreMm = {7.8f, 7.85f}, .MassGr = {150.0f, 180.0f}, .G7BC = {0.25f}}
+     */
+    struct BulletQuery
+    {
+        FloatRange CallibreMm = {};
+        FloatRange MassGr = {};
+        FloatRange G1BC = {};
+        FloatRange G7BC = {};
+        // exact match, empty for any
+        std::string_view Company = {};
+    };
+
+    /**
+     * @brief Bullet catalogue with the ballistic fields as structure-of-arrays, interned strings and sorted indices.
+     *
+     * Queries narrow down the candidates with a binary search on the most selective sorted index, then check the
+     * remaining fields against the flat arrays. Add invalidates the indices until BuildIndices is called, queries in
+     * between fall back to a linear scan. Queries are const and may run concurrently.
+     */
+    class BulletCatalogue
+    {
+    public:
+        enum class IndexField
+        {
+            CallibreMm,
+            MassGr,
+            G1BC,
+            G7BC,
+            Count
+        };
+
+        BulletCatalogue() = default;
+        explicit BulletCatalogue(std::span<const BulletData> InBullets)
+        {
+            Add(InBullets);
+            BuildIndices();
+        }
+
+        size_t Add(const BulletData& InBullet);
+        void Add(std::span<const BulletData> InBullets);
+        void Clear();
+
+        // sort the bullets by each indexed field, call after adding
+        void BuildIndices();
+
+        bool IsIndexed() const
+        {
+            return bIndexed;
+        }
+
+        size_t Size() const
+        {
+            return MassGr.size();
+        }
+
+        // materialise bullet n
+        BulletData GetBullet(size_t Index) const;
+
+        std::string_view GetCompany(size_t Index) const { return Strings.Get(CompanyId[Index]); }
+        std::string_view GetName(size_t Index) const { return Strings.Get(NameId[Index]); }
+        std::string_view GetDescription(size_t Index) const { return Strings.Get(DescriptionId[Index]); }
+
+        std::span<const float> GetField(IndexField Field) const
+        {
+            return *FieldArrays()[static_cast<size_t>(Field)];
+        }
+
+        const StringPool& GetStrings() const
+        {
+            return Strings;
+        }
+
+        /**
+         * Indices of the bullets matching InQuery, in ascending order
+         */
+        void Query(const BulletQuery& InQuery, std::vector<uint32_t>& OutIndices) const;
+        std::vector<uint32_t> Query(const BulletQuery& InQuery) const
+        {
+            std::vector<uint32_t> Indices;
+            Query(InQuery, Indices);
+            return Indices;
+        }
+
+    private:
+        friend class SnapshotSerializer;
+
+        static constexpr size_t NumIndexFields = static_cast<size_t>(IndexField::Count);
+
+        std::array<const FlatArray<float>*, NumIndexFields> FieldArrays() const
+        {
+            return {&CallibreMm, &MassGr, &G1BC, &G7BC};
+        }
+
+        bool Matches(const BulletQuery& InQuery, bool bAnyCompany, uint32_t Company, size_t Index) const;
+
+        FlatArray<float> CallibreMm;
+        FlatArray<float> MassGr;
+        FlatArray<float> G1BC;
+        FlatArray<float> G7BC;
+        FlatArray<uint32_t> CompanyId;
+        FlatArray<uint32_t> NameId;
+        FlatArray<uint32_t> DescriptionId;
+        StringPool Strings;
+
+        // per indexed field, the bullet indices in order of the field and the field values in that order
+        struct SortedIndex
+        {
+            FlatArray<uint32_t> Order;
+            FlatArray<float> Keys;
+        };
+        std::array<SortedIndex, NumIndexFields> Indices;
+        bool bIndexed = false;
+    };
+}
@@ -1,6 +1,10 @@
 ﻿#pragma once
+#include <filesystem>
 #include <numbers>
+#include <span>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace Ballistics
 {
@@ -45,10 +49,38 @@ namespace Ballistics
                 "weight_gr": "83"
            }
          * 
-         * @param JsonString 
-         * @return 
+         * Keys may be in any order and layout; unknown keys and empty values are skipped.
+         *
+         * @param JsonString a single JSON object
+         * @return false if it isn't one
          */
         bool ParseFromJsonString(const std::string& JsonString);
     };
 
+    struct BulletCatalogueLoadStats
+    {
+        size_t NumBytes = 0;
+        size_t NumBullets = 0;
+        double Seconds = 0.0;
+
+        double GetMBPerSecond() const
+        {
+            return Seconds > 0.0 ? static_cast<double>(NumBytes) / (1024.0 * 1024.0 * Seconds) : 0.0;
+        }
+    };
+
+    /**
+     * Parse a whole ammolytics catalogue, a JSON array of bullet objects as accepted by ParseFromJsonString (or a
+     * single such object), appending the bullets to OutBullets. One pass over the text without copying it; numbers are
+     * parsed in place and only the string fields allocate.
+     * @return false on malformed JSON, OutBullets then holds the bullets before the error
+     */
+    bool ParseBulletCatalogueJson(std::string_view Json, std::vector<BulletData>& OutBullets, BulletCatalogueLoadStats* OutStats = nullptr);
+
+    /**
+     * Memory map and parse catalogue files, e.g. one per manufacturer, appending the bullets to OutBullets
+     * @return false if a file can't be read or is malformed, the remaining files are still loaded
+     */
+    bool LoadBulletCatalogueJson(const std::filesystem::path& Path, std::vector<BulletData>& OutBullets, BulletCatalogueLoadStats* OutStats = nullptr);
+    bool LoadBulletCatalogueJson(std::span<const std::filesystem::path> Paths, std::vector<BulletData>& OutBullets, BulletCatalogueLoadStats* OutStats = nullptr);
 }
@@ -1,5 +1,10 @@
 ﻿#pragma once
+#include <cmath>
 #include <map>
+#include <span>
+#include <vector>
+#include <cstdint>
+#include "FlatArray.h"
 
 namespace Ballistics
 {
@@ -7,5 +12,103 @@ namespace Ballistics
     extern const DragTableType G1;
     extern const DragTableType G7;
 
+    // what a compiled drag table returns outside of its Mach range
+    enum class DragExtrapolation : uint32_t
+    {
+        // the rule of the std::map lookup: 0 above the last knot, a line to (0,0) below the first
+        Legacy,
+        // Cd of the nearest end knot
+        Clamp,
+        // continue the end segment, never below 0
+        Linear,
+    };
+
+    // how a compiled drag table interpolates between its knots
+    enum class DragInterpolation : uint32_t
+    {
+        // straight segments, Cd is continuous but its slope jumps at every knot
+        Linear,
+        // Fritsch-Carlson monotone cubic Hermite segments, the slope is continuous too and there is no overshoot
+        // between knots, so adaptive integrators don't have to shorten their steps at every knot
+        MonotoneCubic,
+    };
+
+    struct DragTableOptions
+    {
+        DragExtrapolation Extrapolation = DragExtrapolation::Clamp;
+        DragInterpolation Interpolation = DragInterpolation::Linear;
+        // resample to this many uniformly spaced knots, interpolating linearly between the source knots, so that the
+        // grid maps straight to the segment; 0 keeps the source knots
+        uint32_t NumUniformKnots = 0;
+    };
+
+    /**
+     * @brief Flat, lookup-optimised form of a DragTableType.
+     *
+     * The Mach and Cd knots are stored in contiguous sorted arrays together with the slope of each
+     * segment, and a uniform grid over Mach maps any Mach number directly to (at most one knot away from)
+     * its segment, so a lookup is a multiply, an array index and a lerp (or a cubic with precomputed coefficients);
+     * no tree walk and no allocations.
+     * Build it once from the std::map source table and reuse it for every solve, or view one in a mapped snapshot.
+     */
+    struct CompiledDragTable
+    {
+        CompiledDragTable() = default;
+        // the built-in tables, with the Legacy extrapolation of GetDragCoefficient on the source table
+        explicit CompiledDragTable(const DragTableType& InTable);
+        // a custom curve, e.g. from LoadDragCurve; left empty unless ValidateDragCurve accepts the knots
+        CompiledDragTable(std::span<const float> InMach, std::span<const float> InCd, const DragTableOptions& Options = {});
+
+        // interpolated drag coefficient at Mach, extrapolated outside of the knots as set by Extrapolation
+        float GetAtMach(float Mach) const;
+
+        bool IsEmpty() const
+        {
+            return Mach.size() < 2;
+        }
+
+        FlatArray<float> Mach;
+        FlatArray<float> Cd;
+        // (Cd[n+1]-Cd[n])/(Mach[n+1]-Mach[n])
+        FlatArray<float> Slope;
+        // MonotoneCubic only, 3 per segment: Cd[n] + d*(Cubic[3n] + d*(Cubic[3n+1] + d*Cubic[3n+2])), d = Mach-Mach[n]
+        FlatArray<float> Cubic;
+        // segment index for each uniform grid cell, cell n starts at Mach[0] + n/GridInvStep
+        FlatArray<uint32_t> GridSegment;
+        float GridInvStep = 0.0f;
+        // the knot spacing if knot n is exactly Mach[0] + n*UniformStep, as resampled with NumUniformKnots, else 0;
+        // the segment is then computed directly, which lets the SIMD kernel skip the grid
+        float UniformStep = 0.0f;
+        DragExtrapolation Extrapolation = DragExtrapolation::Legacy;
+        DragInterpolation Interpolation = DragInterpolation::Linear;
+        // HashDragTable of the knots and the rules above, set by Compile; tables that look up the same Cd share it
+        uint64_t ContentHash = 0;
+
+    private:
+        void Compile();
+        void CompileCubic(const std::vector<float>& Secant);
+    };
+    extern const CompiledDragTable CompiledG1;
+    extern const CompiledDragTable CompiledG7;
+
+    // FNV-1a over the knots, the extrapolation and the interpolation; a content key for caches
+    uint64_t HashDragTable(const CompiledDragTable& Table);
+
+    // speed of sound in dry air, m/s
+    inline float GetSpeedOfSound(float TemperatureK)
+    {
+        constexpr float Gamma = 1.4f;
+        constexpr float R = 287.05f;
+        return std::sqrt(Gamma * R * TemperatureK);
+    }
+
     float GetDragCoefficient(const DragTableType& Table, float Speed, float TemperatureK);
-}
\ No newline at end of file
+    float GetDragCoefficient(const CompiledDragTable& Table, float Speed, float TemperatureK);
+
+    // drag coefficient at Mach directly, for solvers that convert speed to Mach with a cached 1/speed of sound
+    float GetDragCoefficientAtMach(const DragTableType& Table, float Mach);
+    inline float GetDragCoefficientAtMach(const CompiledDragTable& Table, float Mach)
+    {
+        return Table.GetAtMach(Mach);
+    }
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Ballistics.h"
+#include "ThreadPool.h"
+
+namespace Ballistics
+{
+    enum class TargetShape
+    {
+        Rectangle,
+        // Width and Height are the diameters, equal for a circle
+        Ellipse,
+    };
+
+    /**
+     * @brief Target at the dispersion distance, in the plane of the line of sight: Y up from it and Z to its right.
+     */
+    struct DispersionTarget
+    {
+        TargetShape Shape = TargetShape::Ellipse;
+        float WidthM = 0.5f;
+        float HeightM = 0.5f;
+        float CentreYM = 0.0f;
+        float CentreZM = 0.0f;
+
+        bool Contains(float Y, float Z) const;
+    };
+
+    /**
+     * @brief Sources of shot to shot variation, each an independent normal distribution around the nominal firing
+     * and environment data, and how to sample them.
+     */
+    struct DispersionParams
+    {
+        size_t NumSamples = 1000;
+        // the same seed and parameters always give the same result, whatever the number of threads
+        uint64_t Seed = 0;
+        // samples are solved and reduced in batches of this size
+        size_t BatchSize = 64;
+
+        float DistanceM = 500.0f;
+        float MuzzleVelocitySdMs = 0.0f;
+        // relative, e.g. 0.02 for 2%
+        float BallisticCoefficientSd = 0.0f;
+        // wind in the firing frame, X downrange and Z from the left
+        float HeadWindSdMs = 0.0f;
+        float CrossWindSdMs = 0.0f;
+        // per axis aiming error of the shooter, in radians
+        float AimSdRad = 0.0f;
+        // added to the zero angle and to the direction of fire, e.g. to hold over for the distance or into the wind
+        float HoldElevationRad = 0.0f;
+        float HoldWindageRad = 0.0f;
+
+        float TimeStep = 0.001f;
+        float MaxTime = 10.0f;
+        IntegratorType Integrator = IntegratorType::PointMass3D;
+        bool bCoriolis = false;
+        // keep every impact in the result, e.g. to draw the group
+        bool bKeepImpacts = false;
+    };
+
+    struct DispersionImpact
+    {
+        // relative to the line of sight at the dispersion distance
+        float YM = 0.0f;
+        float ZM = 0.0f;
+        float VelocityMs = 0.0f;
+        float TimeOfFlightS = 0.0f;
+        // false if the trajectory ended short of the distance
+        bool bValid = false;
+        bool bHit = false;
+    };
+
+    /**
+     * @brief Impact statistics over the samples which reached the distance; the hit probability counts those which
+     * didn't as misses.
+     */
+    struct DispersionResult
+    {
+        size_t NumSamples = 0;
+        size_t NumValid = 0;
+        size_t NumHits = 0;
+        float HitProbability = 0.0f;
+        // binomial standard error of HitProbability
+        float HitProbabilityStdError = 0.0f;
+
+        float MeanYM = 0.0f;
+        float MeanZM = 0.0f;
+        float SdYM = 0.0f;
+        float SdZM = 0.0f;
+        float CorrelationYZ = 0.0f;
+        // mean distance of the impacts from their centre
+        float MeanRadiusM = 0.0f;
+        float MeanVelocityMs = 0.0f;
+        float MeanTimeOfFlightS = 0.0f;
+
+        // in sample order, only with DispersionParams::bKeepImpacts
+        std::vector<DispersionImpact> Impacts;
+    };
+
+    /**
+     * Solve a single sample of the simulation; a pure function of the parameters and SampleIndex
+     */
+    DispersionImpact SolveDispersionSample(const CompiledDragTable& InDragTable, const FiringData& InFiringData, const EnvironmentData& Environment, const DispersionParams& Params, const DispersionTarget& Target, uint64_t SampleIndex);
+
+    /**
+     * Monte Carlo estimate of the impact distribution and hit probability of InFiringData on Target, solving batches
+     * of samples over the pool. InFiringData is used as zeroed, zero it in first for the nominal environment.
+     * Batches are reduced in order in double precision, so the result only depends on the parameters.
+     */
+    DispersionResult SimulateDispersion(WorkStealingPool& Pool, const CompiledDragTable& InDragTable, const FiringData& InFiringData, const EnvironmentData& Environment, const DispersionParams& Params, const DispersionTarget& Target);
+}
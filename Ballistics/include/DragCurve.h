@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "Data.h"
+
+namespace Ballistics
+{
+    enum class DragCurveStatus
+    {
+        Ok,
+        CantOpen,
+        // neither CSV nor JSON as described at ParseDragCurveCsv and ParseDragCurveJson
+        Malformed,
+        // fewer than two knots
+        TooFewKnots,
+        // a knot's Mach isn't greater than the one before
+        NonMonotonicMach,
+        // a negative or non-finite Mach or Cd
+        InvalidValue,
+    };
+
+    /**
+     * Check the knots are usable as a drag table: as many Cd as Mach, at least two knots, strictly increasing Mach
+     * and finite, non-negative values
+     * @param OutKnot if not null, set to the first offending knot
+     */
+    DragCurveStatus ValidateDragCurve(std::span<const float> Mach, std::span<const float> Cd, size_t* OutKnot = nullptr);
+
+    /**
+     * @brief Measured drag coefficient against Mach, e.g. from Doppler radar, to compile into a CompiledDragTable.
+     */
+    struct DragCurve
+    {
+        std::vector<float> Mach;
+        std::vector<float> Cd;
+
+        /**
+         * Check the knots are usable as a drag table
+         * @param OutKnot if not null, set to the first offending knot
+         */
+        DragCurveStatus Validate(size_t* OutKnot = nullptr) const
+        {
+            return ValidateDragCurve(Mach, Cd, OutKnot);
+        }
+
+        CompiledDragTable Compile(const DragTableOptions& Options = {}) const
+        {
+            return CompiledDragTable(Mach, Cd, Options);
+        }
+    };
+
+    /**
+     * Parse a curve as Mach,Cd lines, e.g.
+     *
+     *  # 6.5mm 140gr, radar
+     *  Mach,Cd
+     *  0.50,0.232
+     *  0.60,0.231
+     *
+     * Columns may be separated by commas, semicolons or whitespace and further columns are ignored; blank lines,
+     * # comments and a header line before the first knot are skipped. The curve is validated.
+     */
+    DragCurveStatus ParseDragCurveCsv(std::string_view Csv, DragCurve& OutCurve);
+
+    /**
+     * Parse a curve as a JSON object with "mach" and "cd" arrays of the same length, e.g.
+     *
+     *  {"name": "6.5mm 140gr", "mach": [0.5, 0.6], "cd": [0.232, 0.231]}
+     *
+     * Numbers may be quoted and other keys are ignored. The curve is validated.
+     */
+    DragCurveStatus ParseDragCurveJson(std::string_view Json, DragCurve& OutCurve);
+
+    // memory map and parse a .json file as JSON and anything else as CSV
+    DragCurveStatus LoadDragCurve(const std::filesystem::path& Path, DragCurve& OutCurve);
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <span>
+#include "Data.h"
+
+namespace Ballistics
+{
+    // instruction sets the drag kernel can use, in increasing order
+    enum class SimdLevel
+    {
+        Scalar,
+        // 4 lanes, gathers are scalar loads
+        SSE41,
+        // 8 lanes with hardware gathers
+        AVX2,
+    };
+
+    // the best level the CPU supports, detected once
+    SimdLevel GetSupportedSimdLevel();
+
+    /**
+     * @brief Drag coefficients for many lanes at once, OutCd[n] = Table.GetAtMach(Mach[n]).
+     *
+     * Vectorises the grid lookup of CompiledDragTable: the cell index is computed for all lanes, the segments and
+     * knots are gathered, and the at most one knot correction, the interpolation and the extrapolation are blends.
+     * A vector whose lanes land more than one knot from their grid cell, which only happens for tables with more knots
+     * than the grid has cells, is done by the scalar lookup. For a uniform table (see UniformStep) the segment is
+     * computed directly and only the coefficients are gathered, which is several times cheaper where gathers are slow.
+     * Results match GetAtMach to rounding.
+     *
+     * @param OutCd the same size as Mach, or Mach itself
+     * @param Level capped to GetSupportedSimdLevel
+     */
+    void GetDragCoefficientsAtMach(const CompiledDragTable& Table, std::span<const float> Mach, std::span<float> OutCd, SimdLevel Level = GetSupportedSimdLevel());
+
+    // OutCd[n] = GetDragCoefficient(Table, Speed[n], TemperatureK[n]), with the Mach conversion vectorised too
+    void GetDragCoefficients(const CompiledDragTable& Table, std::span<const float> Speed, std::span<const float> TemperatureK, std::span<float> OutCd, SimdLevel Level = GetSupportedSimdLevel());
+}
@@ -0,0 +1,147 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Ballistics
+{
+    /**
+     * @brief Contiguous array that either owns its elements or views memory owned elsewhere, e.g. a mapped snapshot.
+     *
+     * Reads go through a plain pointer whichever it is, with the std::vector names so that it can stand in for one.
+     * The first modification of a view copies the viewed elements into owned storage (copy on write), so a
+     * structure loaded zero-copy from a snapshot can still be added to.
+     */
+    template<typename T>
+    class FlatArray
+    {
+    public:
+        FlatArray() = default;
+        FlatArray(std::vector<T>&& InOwned)
+            : Owned(std::move(InOwned))
+        {
+            Repoint();
+        }
+
+        // view Elements without copying them, they must outlive the array or its modification
+        static FlatArray View(std::span<const T> Elements)
+        {
+            FlatArray Array;
+            Array.Data = Elements.data();
+            Array.Size = Elements.size();
+            Array.bView = true;
+            return Array;
+        }
+
+        FlatArray(const FlatArray& Other)
+            : Owned(Other.Owned), Data(Other.Data), Size(Other.Size), bView(Other.bView)
+        {
+            Repoint();
+        }
+        FlatArray(FlatArray&& Other) noexcept
+            : Owned(std::move(Other.Owned)), Data(Other.Data), Size(Other.Size), bView(Other.bView)
+        {
+            Repoint();
+            Other.Owned.clear();
+            Other.bView = false;
+            Other.Repoint();
+        }
+        FlatArray& operator=(const FlatArray& Other)
+        {
+            if (this != &Other)
+            {
+                Owned = Other.Owned;
+                Data = Other.Data;
+                Size = Other.Size;
+                bView = Other.bView;
+                Repoint();
+            }
+            return *this;
+        }
+        FlatArray& operator=(FlatArray&& Other) noexcept
+        {
+            if (this != &Other)
+            {
+                Owned = std::move(Other.Owned);
+                Data = Other.Data;
+                Size = Other.Size;
+                bView = Other.bView;
+                Repoint();
+                Other.Owned.clear();
+                Other.bView = false;
+                Other.Repoint();
+            }
+            return *this;
+        }
+
+        bool IsView() const { return bView; }
+        std::span<const T> GetSpan() const { return {Data, Size}; }
+        operator std::span<const T>() const { return GetSpan(); }
+
+        size_t size() const { return Size; }
+        bool empty() const { return Size == 0; }
+        const T* data() const { return Data; }
+        const T* begin() const { return Data; }
+        const T* end() const { return Data + Size; }
+        const T& front() const { return Data[0]; }
+        const T& back() const { return Data[Size - 1]; }
+        const T& operator[](size_t Index) const { return Data[Index]; }
+
+        void push_back(const T& Value)
+        {
+            MakeOwned();
+            Owned.push_back(Value);
+            Repoint();
+        }
+        void append(std::span<const T> Values)
+        {
+            MakeOwned();
+            Owned.insert(Owned.end(), Values.begin(), Values.end());
+            Repoint();
+        }
+        void reserve(size_t Capacity)
+        {
+            MakeOwned();
+            Owned.reserve(Capacity);
+            Repoint();
+        }
+        void clear()
+        {
+            Owned.clear();
+            bView = false;
+            Repoint();
+        }
+        // writable element, copying a view first
+        T& Mutable(size_t Index)
+        {
+            MakeOwned();
+            return Owned[Index];
+        }
+
+    private:
+        void MakeOwned()
+        {
+            if (bView)
+            {
+                Owned.assign(Data, Data + Size);
+                bView = false;
+                Repoint();
+            }
+        }
+
+        void Repoint()
+        {
+            if (!bView)
+            {
+                Data = Owned.data();
+                Size = Owned.size();
+            }
+        }
+
+        std::vector<T> Owned;
+        const T* Data = nullptr;
+        size_t Size = 0;
+        bool bView = false;
+    };
+}
@@ -0,0 +1,136 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+namespace Ballistics
+{
+    /**
+     * Forward only cursor over JSON text, just enough of it for the bullet catalogue and drag curves: strings are
+     * returned as views of the text, still escaped, and values that aren't needed are skipped without being parsed.
+     */
+    struct JsonReader
+    {
+        const char* It;
+        const char* End;
+
+        explicit JsonReader(std::string_view Json)
+            : It(Json.data()), End(Json.data() + Json.size())
+        {
+            // UTF-8 byte order mark
+            if (Json.starts_with("\xEF\xBB\xBF"))
+            {
+                It += 3;
+            }
+        }
+
+        void SkipWhitespace()
+        {
+            while (It != End && (*It == ' ' || *It == '\n' || *It == '\r' || *It == '\t'))
+            {
+                ++It;
+            }
+        }
+
+        // the next non whitespace character, or 0 at the end
+        char Peek()
+        {
+            SkipWhitespace();
+            return It != End ? *It : '\0';
+        }
+
+        bool Consume(char Expected)
+        {
+            if (Peek() != Expected)
+            {
+                return false;
+            }
+            ++It;
+            return true;
+        }
+
+        bool ReadString(std::string_view& OutRaw, bool& bOutEscaped)
+        {
+            if (!Consume('"'))
+            {
+                return false;
+            }
+            const char* Start = It;
+            for (;;)
+            {
+                It = static_cast<const char*>(std::memchr(It, '"', End - It));
+                if (!It)
+                {
+                    It = End;
+                    return false;
+                }
+                // an odd number of backslashes escapes the quote
+                const char* Backslash = It;
+                while (Backslash != Start && Backslash[-1] == '\\')
+                {
+                    --Backslash;
+                }
+                if ((It - Backslash) % 2 == 0)
+                {
+                    break;
+                }
+                ++It;
+            }
+            OutRaw = std::string_view(Start, It - Start);
+            bOutEscaped = std::memchr(Start, '\\', It - Start) != nullptr;
+            ++It;
+            return true;
+        }
+
+        // a number or literal, up to the next delimiter
+        std::string_view ReadScalar()
+        {
+            SkipWhitespace();
+            const char* Start = It;
+            while (It != End && *It != ',' && *It != '}' && *It != ']' && *It != ' ' && *It != '\n' && *It != '\r' && *It != '\t')
+            {
+                ++It;
+            }
+            return {Start, static_cast<size_t>(It - Start)};
+        }
+
+        bool SkipValue()
+        {
+            std::string_view Raw;
+            bool bEscaped;
+            switch (Peek())
+            {
+            case '"':
+                return ReadString(Raw, bEscaped);
+            case '{':
+            case '[':
+            {
+                // strings are skipped whole so that brackets inside them don't count
+                size_t Depth = 0;
+                do
+                {
+                    const char C = Peek();
+                    if (C == '"')
+                    {
+                        if (!ReadString(Raw, bEscaped))
+                        {
+                            return false;
+                        }
+                        continue;
+                    }
+                    if (C == '\0')
+                    {
+                        return false;
+                    }
+                    Depth += (C == '{' || C == '[') ? 1 : 0;
+                    Depth -= (C == '}' || C == ']') ? 1 : 0;
+                    ++It;
+                } while (Depth > 0);
+                return true;
+            }
+            default:
+                return !ReadScalar().empty();
+            }
+        }
+    };
+}
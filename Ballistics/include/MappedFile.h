@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+namespace Ballistics
+{
+    /**
+     * @brief Read-only memory mapping of a whole file.
+     *
+     * The contents are paged in on demand by the OS rather than copied into a buffer, so opening is cheap whatever the
+     * file size and the data is shared between processes mapping the same file. An empty file opens with no data.
+     */
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        explicit MappedFile(const std::filesystem::path& Path)
+        {
+            Open(Path);
+        }
+        ~MappedFile()
+        {
+            Close();
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& Other) noexcept;
+        MappedFile& operator=(MappedFile&& Other) noexcept;
+
+        // closes any mapped file first; false if the file can't be opened or mapped
+        bool Open(const std::filesystem::path& Path);
+        void Close();
+
+        bool IsOpen() const
+        {
+            return bOpen;
+        }
+
+        const std::byte* GetData() const
+        {
+            return static_cast<const std::byte*>(Data);
+        }
+
+        size_t GetSize() const
+        {
+            return Size;
+        }
+
+        std::string_view GetView() const
+        {
+            return {static_cast<const char*>(Data), Size};
+        }
+
+    private:
+        void Swap(MappedFile& Other) noexcept;
+
+#ifdef _WIN32
+        void* FileHandle = nullptr;
+        void* MappingHandle = nullptr;
+#else
+        int FileDescriptor = -1;
+#endif
+        const void* Data = nullptr;
+        size_t Size = 0;
+        bool bOpen = false;
+    };
+}
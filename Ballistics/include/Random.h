@@ -0,0 +1,94 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+
+namespace Ballistics
+{
+    /**
+     * @brief Philox4x32-10 counter based random number generator (Salmon et al., "Parallel random numbers: as easy as
+     * 1, 2, 3").
+     *
+     * Every block of four outputs is a pure function of (Key, Counter), so a stream keyed by a seed and indexed by
+     * e.g. a sample number gives the same numbers whichever thread draws them and in whatever order. There is no state
+     * to share or to split between threads.
+     */
+    class CounterRandom
+    {
+    public:
+        using BlockType = std::array<uint32_t, 4>;
+
+        /**
+         * @param Seed the key, shared by all streams of one simulation
+         * @param Stream independent stream within it, e.g. the sample index
+         */
+        CounterRandom(uint64_t Seed, uint64_t Stream)
+            : Key{static_cast<uint32_t>(Seed), static_cast<uint32_t>(Seed >> 32)},
+            Counter{static_cast<uint32_t>(Stream), static_cast<uint32_t>(Stream >> 32), 0, 0}
+        {
+        }
+
+        // the 4 x 32 bit block for a counter and key
+        static constexpr BlockType Philox(BlockType InCounter, std::array<uint32_t, 2> InKey)
+        {
+            constexpr uint32_t M0 = 0xD2511F53u;
+            constexpr uint32_t M1 = 0xCD9E8D57u;
+            constexpr uint32_t W0 = 0x9E3779B9u;
+            constexpr uint32_t W1 = 0xBB67AE85u;
+            for (int Round = 0; Round < 10; ++Round)
+            {
+                const uint64_t Product0 = static_cast<uint64_t>(M0) * InCounter[0];
+                const uint64_t Product1 = static_cast<uint64_t>(M1) * InCounter[2];
+                InCounter = {
+                    static_cast<uint32_t>(Product1 >> 32) ^ InCounter[1] ^ InKey[0],
+                    static_cast<uint32_t>(Product1),
+                    static_cast<uint32_t>(Product0 >> 32) ^ InCounter[3] ^ InKey[1],
+                    static_cast<uint32_t>(Product0)};
+                InKey[0] += W0;
+                InKey[1] += W1;
+            }
+            return InCounter;
+        }
+
+        uint32_t NextUInt()
+        {
+            if (BlockIndex == Block.size())
+            {
+                Block = Philox(Counter, Key);
+                ++Counter[2];
+                BlockIndex = 0;
+            }
+            return Block[BlockIndex++];
+        }
+
+        // uniform in (0,1], never 0 so that it can be passed to log
+        float NextUniform()
+        {
+            return static_cast<float>((NextUInt() >> 8) + 1) * (1.0f / 16777216.0f);
+        }
+
+        // standard normal, Box-Muller in pairs
+        float NextGaussian()
+        {
+            if (bHasSpareGaussian)
+            {
+                bHasSpareGaussian = false;
+                return SpareGaussian;
+            }
+            const float Radius = std::sqrt(-2.0f * std::log(NextUniform()));
+            const float Angle = 2.0f * std::numbers::pi_v<float> * NextUniform();
+            SpareGaussian = Radius * std::sin(Angle);
+            bHasSpareGaussian = true;
+            return Radius * std::cos(Angle);
+        }
+
+    private:
+        std::array<uint32_t, 2> Key;
+        BlockType Counter;
+        BlockType Block{};
+        size_t BlockIndex = Block.size();
+        float SpareGaussian = 0.0f;
+        bool bHasSpareGaussian = false;
+    };
+}
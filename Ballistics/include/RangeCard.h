@@ -0,0 +1,106 @@
+#pragma once
+#include <cmath>
+#include <span>
+#include <vector>
+#include "Ballistics.h"
+#include "ThreadPool.h"
+
+namespace Ballistics
+{
+    /**
+     * @brief One row of a range card (dope table), all values at Distance metres down range.
+     *
+     * Drop is measured from the line of sight, i.e. relative to the firing height, so it is ~0 at the zero distance.
+     */
+    struct RangeCardRow
+    {
+        float Distance = 0.0f;
+        float DropM = 0.0f;
+        // drop as an angle, in milliradians
+        float DropMil = 0.0f;
+        // lateral drift to the right; only non-zero with the 3D solver
+        float DriftM = 0.0f;
+        float VelocityMs = 0.0f;
+        float EnergyJ = 0.0f;
+        float TimeOfFlightS = 0.0f;
+        // false if the trajectory ended (ground, MaxTime) before reaching Distance, or the load couldn't be zeroed
+        bool bValid = false;
+    };
+
+    /**
+     * @brief A load to produce range cards for; the firing data is zeroed in against DragTable for every environment.
+     */
+    struct RangeCardLoad
+    {
+        FiringData Firing;
+        const CompiledDragTable* DragTable = &CompiledG7;
+    };
+
+    struct RangeCardParams
+    {
+        // one row every DistanceStep metres, starting at DistanceStep
+        float DistanceStep = 25.0f;
+        float MaxDistance = 1000.0f;
+        float ZeroToleranceM = 0.01f;
+        float TimeStep = 0.01f;
+        float MaxTime = 10.0f;
+        // PointMass3D for wind, Coriolis and spin drift; the zeroing always uses the 2D solver
+        IntegratorType Integrator = IntegratorType::HybridEulerRk4;
+        bool bCoriolis = false;
+    };
+
+    /**
+     * @brief Preallocated storage for the range cards of every (load, environment) pair.
+     */
+    class RangeCards
+    {
+    public:
+        RangeCards() = default;
+        RangeCards(size_t InNumLoads, size_t InNumEnvironments, const RangeCardParams& Params)
+        {
+            Resize(InNumLoads, InNumEnvironments, Params);
+        }
+
+        void Resize(size_t InNumLoads, size_t InNumEnvironments, const RangeCardParams& Params)
+        {
+            NumLoads = InNumLoads;
+            NumEnvironments = InNumEnvironments;
+            // rounded so that e.g. 9/0.3, which is just under 30 in float, still has its last row
+            NumRows = Params.DistanceStep > 0.0f ? static_cast<size_t>(std::floor(Params.MaxDistance / Params.DistanceStep + 1e-4f)) : 0;
+            Rows.assign(NumLoads * NumEnvironments * NumRows, RangeCardRow{});
+        }
+
+        std::span<RangeCardRow> GetCard(size_t LoadIndex, size_t EnvironmentIndex)
+        {
+            return {Rows.data() + (LoadIndex * NumEnvironments + EnvironmentIndex) * NumRows, NumRows};
+        }
+
+        std::span<const RangeCardRow> GetCard(size_t LoadIndex, size_t EnvironmentIndex) const
+        {
+            return {Rows.data() + (LoadIndex * NumEnvironments + EnvironmentIndex) * NumRows, NumRows};
+        }
+
+        size_t GetNumLoads() const { return NumLoads; }
+        size_t GetNumEnvironments() const { return NumEnvironments; }
+        size_t GetNumRows() const { return NumRows; }
+
+    private:
+        size_t NumLoads = 0;
+        size_t NumEnvironments = 0;
+        size_t NumRows = 0;
+        std::vector<RangeCardRow> Rows;
+    };
+
+    /**
+     * Generate a single range card, zeroing in InLoad for Environment first if it has a zero distance; if the zeroing
+     * doesn't converge no row is valid
+     * @param OutRows preallocated rows, row n is at (n+1)*DistanceStep
+     */
+    void GenerateRangeCard(std::span<RangeCardRow> OutRows, const RangeCardLoad& InLoad, const EnvironmentData& Environment, const RangeCardParams& Params);
+
+    /**
+     * Generate range cards for every load in every environment, spread over the pool.
+     * @param OutCards resized to InLoads.size() x InEnvironments.size() cards
+     */
+    void GenerateRangeCards(WorkStealingPool& Pool, RangeCards& OutCards, std::span<const RangeCardLoad> InLoads, std::span<const EnvironmentData> InEnvironments, const RangeCardParams& Params);
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "BulletCatalogue.h"
+#include "Data.h"
+#include "MappedFile.h"
+
+namespace Ballistics
+{
+    // a drag table to write, e.g. {"G7", &CompiledG7}
+    struct SnapshotDragTable
+    {
+        std::string_view Name;
+        const CompiledDragTable* Table = nullptr;
+    };
+
+    enum class SnapshotStatus
+    {
+        Ok,
+        CantOpen,
+        // not a snapshot, or a different byte order
+        BadHeader,
+        UnsupportedVersion,
+        // sections outside of the file, misaligned, or inconsistent with each other
+        Corrupt,
+    };
+
+    /**
+     * @brief Zero-copy view of a binary snapshot of a bullet catalogue and compiled drag tables.
+     *
+     * The file is a header and a directory of named, 64 byte aligned flat arrays, exactly the in-memory arrays of
+     * BulletCatalogue, its StringPool and CompiledDragTable; opening it maps the file and validates the header and
+     * directory, and the catalogue and drag tables then view the mapped arrays without parsing or copying them.
+     * The payload itself isn't checksummed, touching it all would defeat the mapping. Modifying the catalogue
+     * copies the modified arrays out of the mapping.
+     */
+    class Snapshot
+    {
+    public:
+        // bumped on any change to the layout or meaning of the arrays; other versions are rejected
+        static constexpr uint32_t Version = 4;
+
+        Snapshot() = default;
+
+        SnapshotStatus Open(const std::filesystem::path& Path);
+        void Close();
+
+        bool IsOpen() const
+        {
+            return File.IsOpen();
+        }
+
+        // empty if the snapshot has no catalogue
+        const BulletCatalogue& GetCatalogue() const
+        {
+            return Catalogue;
+        }
+
+        // nullptr if there's no such table
+        const CompiledDragTable* FindDragTable(std::string_view Name) const;
+        std::vector<std::string_view> GetDragTableNames() const;
+
+    private:
+        MappedFile File;
+        BulletCatalogue Catalogue;
+        std::vector<std::pair<std::string, CompiledDragTable>> DragTables;
+    };
+
+    /**
+     * Write Catalogue, indexed if it isn't already, and the drag tables to a snapshot.
+     * @return false if the file can't be written, or a drag table name is longer than 24 characters or repeated
+     */
+    bool WriteSnapshot(const std::filesystem::path& Path, const BulletCatalogue& Catalogue, std::span<const SnapshotDragTable> DragTables);
+}
@@ -1,18 +1,38 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <concepts>
 #include <functional>
 
 namespace Solver
 {
-    struct RungeKutta4
+    /**
+     * A state that can be integrated; scalars, Algebra::Vector2D or any aggregate state with the same vector operations
+     */
+    template<typename T>
+    concept IntegrableState = requires(T a, T b, float s)
+    {
+        { a + b } -> std::convertible_to<T>;
+        { s * a } -> std::convertible_to<T>;
+    };
+
+    /**
+     * @brief Classic fourth order Runge-Kutta integrator for dY/dt = f(Y,t).
+     *
+     * The derivative is a template parameter so that any callable, typically a small functor, is inlined into Advance.
+     * TState can be a scalar or a full vector state.
+     */
+    template<IntegrableState TState, typename TDerivative>
+    struct TRungeKutta4
     {
         // dY/dt = f(Y,t)
-        using dYdtFunc = std::function<float(float, float)>;
+        using dYdtFunc = TDerivative;
 
-        RungeKutta4() = default;
-        void Initialize(float InY0, float InH, dYdtFunc&& IndYdtF)
+        TRungeKutta4() = default;
+        void Initialize(TState InY0, float InH, dYdtFunc InDerivative)
         {
-            dYdt = std::move(IndYdtF);
+            dYdt = std::move(InDerivative);
             t = 0.0f;
             Y = Y0 = InY0;
             h = InH;
@@ -24,21 +44,146 @@ namespace Solver
             Y = Y0;
         }
 
-        float Advance()
+        const TState& Advance()
         {
             const float HalfH = 0.5f * h;
-            const float K1 = dYdt(Y, t);
-            const float K2 = dYdt(Y + HalfH * K1, t + HalfH);
-            const float K3 = dYdt(Y + HalfH * K2, t + HalfH);
-            const float K4 = dYdt(Y + h, Y + h * K3);
+            const TState K1 = dYdt(Y, t);
+            const TState K2 = dYdt(Y + HalfH * K1, t + HalfH);
+            const TState K3 = dYdt(Y + HalfH * K2, t + HalfH);
+            const TState K4 = dYdt(Y + h * K3, t + h);
             t += h;
             return (Y = Y + (h / 6.0f) * (K1 + 2.0f * K2 + 2.0f * K3 + K4));
         }
 
         dYdtFunc dYdt;
-        float Y0 = 0.0f;
+        TState Y0{};
         float t = 0.0f;
-        float Y = 0.0f;
+        TState Y{};
         float h = 1.0f;
     };
-}
\ No newline at end of file
+
+    // type erased scalar integrator, for derivatives only known at runtime
+    using RungeKutta4 = TRungeKutta4<float, std::function<float(float, float)>>;
+
+    // error norm for scalar states, vector states provide their own Norm found by ADL
+    inline float Norm(float Value)
+    {
+        return std::fabs(Value);
+    }
+
+    /**
+     * @brief Adaptive step size Dormand-Prince 5(4) integrator for dY/dt = f(Y,t).
+     *
+     * Each step is taken with the fifth order solution and its size controlled by the embedded fourth order error
+     * estimate, keeping the error per step below Tolerance * (1 + Norm(Y)). The last derivative evaluation of an
+     * accepted step is reused as the first of the next ("first same as last") so an accepted step costs six
+     * evaluations. Interpolate provides dense output within the last accepted step.
+     */
+    template<IntegrableState TState, typename TDerivative>
+    struct TDormandPrince45
+    {
+        using dYdtFunc = TDerivative;
+
+        TDormandPrince45() = default;
+        void Initialize(TState InY0, float InH, dYdtFunc InDerivative, float InTolerance, float InMinH, float InMaxH)
+        {
+            dYdt = std::move(InDerivative);
+            Tolerance = InTolerance;
+            MinH = InMinH;
+            MaxH = InMaxH;
+            H0 = std::clamp(InH, MinH, MaxH);
+            Y0 = InY0;
+            Reset();
+        }
+
+        void Reset()
+        {
+            t = 0.0f;
+            Y = YPrev = Y0;
+            K1 = KPrev = dYdt(Y, t);
+            LastH = 0.0f;
+            NextH = H0;
+        }
+
+        /**
+         * Take one accepted step, rejecting and retrying with a smaller step as needed
+         * @param InMaxH upper limit for this step, e.g. to not go past an end time
+         * @return the step size taken
+         */
+        float Advance(float InMaxH)
+        {
+            constexpr float A21 = 1.0f / 5.0f;
+            constexpr float A31 = 3.0f / 40.0f, A32 = 9.0f / 40.0f;
+            constexpr float A41 = 44.0f / 45.0f, A42 = -56.0f / 15.0f, A43 = 32.0f / 9.0f;
+            constexpr float A51 = 19372.0f / 6561.0f, A52 = -25360.0f / 2187.0f, A53 = 64448.0f / 6561.0f, A54 = -212.0f / 729.0f;
+            constexpr float A61 = 9017.0f / 3168.0f, A62 = -355.0f / 33.0f, A63 = 46732.0f / 5247.0f, A64 = 49.0f / 176.0f, A65 = -5103.0f / 18656.0f;
+            constexpr float B1 = 35.0f / 384.0f, B3 = 500.0f / 1113.0f, B4 = 125.0f / 192.0f, B5 = -2187.0f / 6784.0f, B6 = 11.0f / 84.0f;
+            // fifth minus fourth order weights
+            constexpr float E1 = 71.0f / 57600.0f, E3 = -71.0f / 16695.0f, E4 = 71.0f / 1920.0f, E5 = -17253.0f / 339200.0f, E6 = 22.0f / 525.0f, E7 = -1.0f / 40.0f;
+
+            for (;;)
+            {
+                const float h = std::min(NextH, InMaxH);
+                const TState K2 = dYdt(Y + h * (A21 * K1), t + h / 5.0f);
+                const TState K3 = dYdt(Y + h * (A31 * K1 + A32 * K2), t + h * (3.0f / 10.0f));
+                const TState K4 = dYdt(Y + h * (A41 * K1 + A42 * K2 + A43 * K3), t + h * (4.0f / 5.0f));
+                const TState K5 = dYdt(Y + h * (A51 * K1 + A52 * K2 + A53 * K3 + A54 * K4), t + h * (8.0f / 9.0f));
+                const TState K6 = dYdt(Y + h * (A61 * K1 + A62 * K2 + A63 * K3 + A64 * K4 + A65 * K5), t + h);
+                const TState YNext = Y + h * (B1 * K1 + B3 * K3 + B4 * K4 + B5 * K5 + B6 * K6);
+                const TState K7 = dYdt(YNext, t + h);
+
+                const float ErrorRatio = Norm(h * (E1 * K1 + E3 * K3 + E4 * K4 + E5 * K5 + E6 * K6 + E7 * K7)) / (Tolerance * (1.0f + Norm(Y)));
+                const float Scale = ErrorRatio > 0.0f ? std::clamp(0.9f * std::pow(ErrorRatio, -0.2f), 0.2f, 5.0f) : 5.0f;
+                if (ErrorRatio <= 1.0f || h <= MinH)
+                {
+                    YPrev = Y;
+                    KPrev = K1;
+                    Y = YNext;
+                    K1 = K7;
+                    t += h;
+                    LastH = h;
+                    NextH = std::clamp(h * Scale, MinH, MaxH);
+                    return h;
+                }
+                NextH = std::max(h * Scale, MinH);
+            }
+        }
+
+        float GetLastStep() const
+        {
+            return LastH;
+        }
+
+        /**
+         * Cubic Hermite dense output over the last accepted step
+         * @param Theta in [0,1], 0 is the start and 1 the end of the step
+         */
+        TState Interpolate(float Theta) const
+        {
+            const float Theta2 = Theta * Theta;
+            const float Theta3 = Theta2 * Theta;
+            return (2.0f * Theta3 - 3.0f * Theta2 + 1.0f) * YPrev
+                + (LastH * (Theta3 - 2.0f * Theta2 + Theta)) * KPrev
+                + (3.0f * Theta2 - 2.0f * Theta3) * Y
+                + (LastH * (Theta3 - Theta2)) * K1;
+        }
+
+        dYdtFunc dYdt;
+        TState Y0{};
+        TState Y{};
+        float t = 0.0f;
+        float Tolerance = 1e-6f;
+        float MinH = 1e-5f;
+        float MaxH = 1.0f;
+
+    private:
+        // start of the last accepted step and the derivative there
+        TState YPrev{};
+        TState KPrev{};
+        // derivative at Y, the first stage of the next step
+        TState K1{};
+        float H0 = 1e-3f;
+        float LastH = 0.0f;
+        float NextH = 1e-3f;
+    };
+}
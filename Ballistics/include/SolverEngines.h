@@ -0,0 +1,430 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include "Ballistics.h"
+#include "Data.h"
+#include "Solver.h"
+
+namespace Ballistics
+{
+    /**
+     * @brief Shared state and the integration loop of the solver engines.
+     *
+     * TDerived is the engine, providing Advance() for one step and InterpolateAtX(X) within the last step, and
+     * optionally hiding Completed or Reset. The calls are resolved statically so that the termination checks and the
+     * step inline into one loop; the runtime choice of engine is made once, outside of it.
+     */
+    template<typename TDerived, typename TDragTable>
+    struct TSolverBase
+    {
+        TrajectoryDataPoint Q;
+        float DragFactor;
+        EnvironmentData Environment;
+        SolverParams Params;
+        const TDragTable& DragTable;
+
+        TSolverBase(const TDragTable& InDragTable, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& SolverParams)
+            : Q(InFiringData),
+            DragFactor(0.5f * Environment.AirDensity * InFiringData.Bullet.GetCrossSectionalArea() / InFiringData.Bullet.GetMassKg()),
+            Environment(Environment),
+            Params(SolverParams),
+            DragTable(InDragTable)
+        {
+        }
+        bool Completed() const
+        {
+            return Q.T >= Params.MaxTime || Q.Position.GetY() < Params.MinY;
+        }
+        bool Terminated() const
+        {
+            return Q.T >= Params.MaxTime;
+        }
+        void Reset(const FiringData& InFiringData)
+        {
+            Q.Initialize(InFiringData);
+        }
+
+        /**
+         * Step to completion passing the output points to Sink, decimated as per the solver params
+         * @param Sink bool(const TrajectoryDataPoint&), returning false stops the integration
+         */
+        template<typename TSink>
+        void Integrate(TSink&& Sink)
+        {
+            TDerived& Solver = static_cast<TDerived&>(*this);
+            const size_t OutputStepStride = std::max<size_t>(Params.OutputStepStride, 1);
+            const float StartX = Q.Position.GetX();
+            size_t NumOutputs = 1;
+            size_t NumSteps = 0;
+            while (!Solver.Completed() && (Params.MaxX==0.0f || Q.Position.GetX()<Params.MaxX))
+            {
+                Solver.Advance();
+                if (Params.OutputDistanceStep > 0.0f)
+                {
+                    // the last step may overshoot MaxX or the ground by far with an adaptive step, nothing is output past either
+                    const float EndX = Params.MaxX == 0.0f ? Q.Position.GetX() : std::min(Q.Position.GetX(), Params.MaxX);
+                    // multiples of the step rather than a running sum, which would drift
+                    for (float NextOutputX = StartX + Params.OutputDistanceStep * static_cast<float>(NumOutputs);
+                        NextOutputX <= EndX;
+                        NextOutputX = StartX + Params.OutputDistanceStep * static_cast<float>(++NumOutputs))
+                    {
+                        const TrajectoryDataPoint Point = Solver.InterpolateAtX(NextOutputX);
+                        if (Point.Position.GetY() < Params.MinY || !Sink(Point))
+                        {
+                            return;
+                        }
+                    }
+                }
+                else if (++NumSteps % OutputStepStride == 0)
+                {
+                    if (!Sink(Q))
+                    {
+                        return;
+                    }
+                }
+            }
+        }
+    };
+
+    /**
+     * dV/dt from drag alone, for the flight speed integrator
+     */
+    template<typename TDragTable>
+    struct DragDeceleration
+    {
+        const TDragTable* DragTable = nullptr;
+        float DragFactor = 0.0f;
+        float InvSpeedOfSound = 0.0f;
+
+        float operator()(float V, float /* t */) const
+        {
+            return -DragFactor * GetDragCoefficientAtMach(*DragTable, V * InvSpeedOfSound) * (V * V);
+        }
+    };
+
+    template<typename TDragTable>
+    struct HybridEulerRk4Solver : TSolverBase<HybridEulerRk4Solver<TDragTable>, TDragTable>
+    {
+        using Base = TSolverBase<HybridEulerRk4Solver<TDragTable>, TDragTable>;
+        using Base::Q;
+        using Base::DragFactor;
+        using Base::Environment;
+        using Base::Params;
+        using Base::DragTable;
+
+        HybridEulerRk4Solver(const TDragTable& InDragTable, const FiringData& InFiringData, const EnvironmentData& InEnvironment, const SolverParams& SolverParams)
+            : Base(InDragTable, InFiringData, InEnvironment, SolverParams)
+        {
+            LastQ = { InFiringData.MuzzleVelocityMs * cosf(InFiringData.ZeroAngle), InFiringData.MuzzleVelocityMs * sinf(InFiringData.ZeroAngle) };
+            
+            VelocitySolver.Initialize(InFiringData.MuzzleVelocityMs, SolverParams.TimeStep, {&InDragTable, DragFactor, InEnvironment.GetInvSpeedOfSound()});
+            PrevQ = Q;
+        }
+
+        void Advance()
+        {
+            PrevQ = Q;
+            const float FlightVelocity = VelocitySolver.Advance();
+            const float AngleOfAttack = std::atan2f(LastQ.GetY(), LastQ.GetX());
+            
+            Q.Velocity = {FlightVelocity*std::cosf(AngleOfAttack), FlightVelocity*std::sinf(AngleOfAttack) + Environment.Gravity * Params.TimeStep};
+            Q.Position += Params.TimeStep * Q.Velocity;
+            LastQ = Q.Velocity;
+            Q.T += Params.TimeStep;
+        }
+
+        void Reset(const FiringData& InFiringData)
+        {
+            Base::Reset(InFiringData);
+            VelocitySolver.Reset();
+            LastQ.SetX(InFiringData.MuzzleVelocityMs * cosf(InFiringData.ZeroAngle));
+            LastQ.SetY(InFiringData.MuzzleVelocityMs * sinf(InFiringData.ZeroAngle));
+            PrevQ = Q;
+        }
+
+        // linear interpolation at downrange distance X within the last step
+        TrajectoryDataPoint InterpolateAtX(float X) const
+        {
+            const float Scale = (X - PrevQ.Position.GetX()) / (Q.Position.GetX() - PrevQ.Position.GetX());
+            TrajectoryDataPoint Point;
+            Point.Position = PrevQ.Position + Scale * (Q.Position - PrevQ.Position);
+            Point.Velocity = PrevQ.Velocity + Scale * (Q.Velocity - PrevQ.Velocity);
+            Point.T = PrevQ.T + Scale * (Q.T - PrevQ.T);
+            return Point;
+        }
+
+        Solver::TRungeKutta4<float, DragDeceleration<TDragTable>> VelocitySolver;
+        Algebra::Vector2D LastQ;
+        // state at the start of the last step
+        TrajectoryDataPoint PrevQ;
+    };
+    
+    /**
+     * Position and velocity as one integrable state for the point mass model
+     */
+    struct PointMassState
+    {
+        Algebra::Vector2D Position;
+        Algebra::Vector2D Velocity;
+
+        friend PointMassState operator+(const PointMassState& Lhs, const PointMassState& Rhs)
+        {
+            return {Lhs.Position + Rhs.Position, Lhs.Velocity + Rhs.Velocity};
+        }
+
+        friend PointMassState operator*(float InScalar, const PointMassState& State)
+        {
+            return {InScalar * State.Position, InScalar * State.Velocity};
+        }
+
+        // max norm, for error control
+        friend float Norm(const PointMassState& State)
+        {
+            return std::max({std::fabs(State.Position.GetX()), std::fabs(State.Position.GetY()), std::fabs(State.Velocity.GetX()), std::fabs(State.Velocity.GetY())});
+        }
+    };
+
+    /**
+     * d(Position,Velocity)/dt for a point mass under drag and gravity
+     */
+    template<typename TDragTable>
+    struct PointMassAcceleration
+    {
+        const TDragTable* DragTable = nullptr;
+        float DragFactor = 0.0f;
+        float InvSpeedOfSound = 0.0f;
+        float Gravity = 0.0f;
+
+        PointMassState operator()(const PointMassState& State, float /* t */) const
+        {
+            const float Speed = std::sqrt(State.Velocity.LengthSq());
+            const float Drag = -DragFactor * GetDragCoefficientAtMach(*DragTable, Speed * InvSpeedOfSound) * Speed;
+            return {State.Velocity, Drag * State.Velocity + Algebra::Vector2D(0.0f, Gravity)};
+        }
+    };
+
+    template<typename TDragTable>
+    struct PointMassDormandPrinceSolver : TSolverBase<PointMassDormandPrinceSolver<TDragTable>, TDragTable>
+    {
+        using Base = TSolverBase<PointMassDormandPrinceSolver<TDragTable>, TDragTable>;
+        using Base::Q;
+        using Base::DragFactor;
+        using Base::Environment;
+        using Base::Params;
+
+        PointMassDormandPrinceSolver(const TDragTable& InDragTable, const FiringData& InFiringData, const EnvironmentData& InEnvironment, const SolverParams& SolverParams)
+            : Base(InDragTable, InFiringData, InEnvironment, SolverParams)
+        {
+            const float InitialStep = SolverParams.TimeStep > 0.0f ? SolverParams.TimeStep : SolverParams.MinTimeStep;
+            Integrator.Initialize({Q.Position, Q.Velocity}, InitialStep, {&InDragTable, DragFactor, InEnvironment.GetInvSpeedOfSound(), InEnvironment.Gravity},
+                SolverParams.Tolerance, SolverParams.MinTimeStep, SolverParams.MaxTimeStep);
+        }
+
+        void Advance()
+        {
+            // don't step past MaxTime
+            Integrator.Advance(std::max(Params.MaxTime - Q.T, Integrator.MinH));
+            Q.Position = Integrator.Y.Position;
+            Q.Velocity = Integrator.Y.Velocity;
+            Q.T = Integrator.t;
+        }
+
+        void Reset(const FiringData& InFiringData)
+        {
+            Base::Reset(InFiringData);
+            Integrator.Y0 = {Q.Position, Q.Velocity};
+            Integrator.Reset();
+        }
+
+        // dense output at downrange distance X within the last step
+        TrajectoryDataPoint InterpolateAtX(float X) const
+        {
+            const float StepT = Integrator.GetLastStep();
+            const PointMassState Start = Integrator.Interpolate(0.0f);
+            float Theta = (X - Start.Position.GetX()) / (Q.Position.GetX() - Start.Position.GetX());
+            PointMassState State = Integrator.Interpolate(Theta);
+            // X(Theta) is monotonic and nearly linear over a step, a couple of Newton iterations are plenty
+            for (int n = 0; n < 2; ++n)
+            {
+                Theta = std::clamp(Theta - (State.Position.GetX() - X) / (StepT * State.Velocity.GetX()), 0.0f, 1.0f);
+                State = Integrator.Interpolate(Theta);
+            }
+
+            TrajectoryDataPoint Point;
+            Point.Position = State.Position;
+            Point.Velocity = State.Velocity;
+            Point.T = Q.T - StepT * (1.0f - Theta);
+            return Point;
+        }
+
+        Solver::TDormandPrince45<PointMassState, PointMassAcceleration<TDragTable>> Integrator;
+    };
+
+    /**
+     * Position and velocity in the firing frame for the 3-DOF point mass model
+     */
+    struct PointMass3DState
+    {
+        Algebra::Vector3D Position;
+        Algebra::Vector3D Velocity;
+
+        friend PointMass3DState operator+(const PointMass3DState& Lhs, const PointMass3DState& Rhs)
+        {
+            return {Lhs.Position + Rhs.Position, Lhs.Velocity + Rhs.Velocity};
+        }
+
+        friend PointMass3DState operator*(float InScalar, const PointMass3DState& State)
+        {
+            return {InScalar * State.Position, InScalar * State.Velocity};
+        }
+    };
+
+    /**
+     * d(Position,Velocity)/dt for a point mass under drag relative to the moving air, gravity and Coriolis
+     */
+    template<typename TDragTable>
+    struct PointMass3DAcceleration
+    {
+        const TDragTable* DragTable = nullptr;
+        float DragFactor = 0.0f;
+        float InvSpeedOfSound = 0.0f;
+        Algebra::Vector3D Gravity;
+        Algebra::Vector3D Wind;
+        // twice the earth's angular velocity in the firing frame, zero without Coriolis
+        Algebra::Vector3D TwoOmega;
+
+        PointMass3DState operator()(const PointMass3DState& State, float /* t */) const
+        {
+            const Algebra::Vector3D AirVelocity = State.Velocity - Wind;
+            const float AirSpeed = std::sqrt(AirVelocity.LengthSq());
+            const float Drag = -DragFactor * GetDragCoefficientAtMach(*DragTable, AirSpeed * InvSpeedOfSound) * AirSpeed;
+            return {State.Velocity, Drag * AirVelocity + Gravity - TwoOmega.Cross(State.Velocity)};
+        }
+    };
+
+    template<typename TDragTable>
+    struct PointMass3DSolver : TSolverBase<PointMass3DSolver<TDragTable>, TDragTable>
+    {
+        using Base = TSolverBase<PointMass3DSolver<TDragTable>, TDragTable>;
+        using Base::Q;
+        using Base::DragFactor;
+        using Base::Params;
+
+        PointMass3DSolver(const TDragTable& InDragTable, const FiringData& InFiringData, const EnvironmentData& InEnvironment, const SolverParams& SolverParams)
+            : Base(InDragTable, InFiringData, InEnvironment, SolverParams)
+        {
+            PointMass3DAcceleration<TDragTable> Acceleration;
+            Acceleration.DragTable = &InDragTable;
+            Acceleration.DragFactor = DragFactor;
+            Acceleration.InvSpeedOfSound = InEnvironment.GetInvSpeedOfSound();
+            Acceleration.Gravity = {0.0f, InEnvironment.Gravity, 0.0f};
+            Acceleration.Wind = InEnvironment.WindMs;
+            if (SolverParams.bCoriolis)
+            {
+                // earth rotation is along north and up, the firing frame is X along the azimuth, Y up and Z to its right
+                constexpr float EarthAngularVelocity = 7.292115e-5f;
+                const float CosLatitude = std::cos(InEnvironment.LatitudeRad);
+                Acceleration.TwoOmega = 2.0f * EarthAngularVelocity * Algebra::Vector3D(
+                    CosLatitude * std::cos(InFiringData.AzimuthRad),
+                    std::sin(InEnvironment.LatitudeRad),
+                    -CosLatitude * std::sin(InFiringData.AzimuthRad));
+            }
+            Integrator.Initialize(MakeState(Q), SolverParams.TimeStep, Acceleration);
+            InitializeSpinDrift(InFiringData);
+            PrevQ = Q;
+        }
+
+        void Advance()
+        {
+            PrevQ = Q;
+            const PointMass3DState& State = Integrator.Advance();
+            Q.Position.Set(State.Position.GetX(), State.Position.GetY());
+            Q.Velocity.Set(State.Velocity.GetX(), State.Velocity.GetY());
+            Q.T = Integrator.t;
+            Q.Drift = State.Position.GetZ();
+            Q.DriftVelocity = State.Velocity.GetZ();
+            if (SpinDriftScale != 0.0f)
+            {
+                // Litz: drift = 1.25 (Sg + 1.2) t^1.83 inches, added to the integrated position rather than modelled as a force
+                const float TimePower = std::pow(Q.T, 0.83f);
+                Q.Drift += SpinDriftScale * TimePower * Q.T;
+                Q.DriftVelocity += 1.83f * SpinDriftScale * TimePower;
+            }
+        }
+
+        void Reset(const FiringData& InFiringData)
+        {
+            Base::Reset(InFiringData);
+            Integrator.Y0 = MakeState(Q);
+            Integrator.Reset();
+            InitializeSpinDrift(InFiringData);
+            PrevQ = Q;
+        }
+
+        // linear interpolation at downrange distance X within the last step
+        TrajectoryDataPoint InterpolateAtX(float X) const
+        {
+            const float Scale = (X - PrevQ.Position.GetX()) / (Q.Position.GetX() - PrevQ.Position.GetX());
+            TrajectoryDataPoint Point;
+            Point.Position = PrevQ.Position + Scale * (Q.Position - PrevQ.Position);
+            Point.Velocity = PrevQ.Velocity + Scale * (Q.Velocity - PrevQ.Velocity);
+            Point.T = PrevQ.T + Scale * (Q.T - PrevQ.T);
+            Point.Drift = PrevQ.Drift + Scale * (Q.Drift - PrevQ.Drift);
+            Point.DriftVelocity = PrevQ.DriftVelocity + Scale * (Q.DriftVelocity - PrevQ.DriftVelocity);
+            return Point;
+        }
+
+        Solver::TRungeKutta4<PointMass3DState, PointMass3DAcceleration<TDragTable>> Integrator;
+        // state at the start of the last step
+        TrajectoryDataPoint PrevQ;
+        // metres per s^1.83, negative for left hand twist
+        float SpinDriftScale = 0.0f;
+
+    private:
+        static PointMass3DState MakeState(const TrajectoryDataPoint& InQ)
+        {
+            return {{InQ.Position.GetX(), InQ.Position.GetY(), 0.0f}, {InQ.Velocity.GetX(), InQ.Velocity.GetY(), 0.0f}};
+        }
+
+        void InitializeSpinDrift(const FiringData& InFiringData)
+        {
+            constexpr float InchToM = 0.0254f;
+            SpinDriftScale = InFiringData.SpinStability > 0.0f ? InchToM * 1.25f * (InFiringData.SpinStability + 1.2f) : 0.0f;
+            if (InFiringData.bLeftHandTwist)
+            {
+                SpinDriftScale = -SpinDriftScale;
+            }
+        }
+    };
+
+    /**
+     * Construct the engine selected by InSolverParams.Integrator and call Func(Engine) with it; the runtime choice of
+     * engine is this one switch per solve, everything Func does with the engine is statically dispatched
+     */
+    template<typename TDragTable, typename TFunc>
+    void WithSolverEngine(const TDragTable& InDragTable, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& InSolverParams, TFunc&& Func)
+    {
+        switch (InSolverParams.Integrator)
+        {
+        case IntegratorType::DormandPrince45:
+        {
+            PointMassDormandPrinceSolver<TDragTable> Solver(InDragTable, InFiringData, Environment, InSolverParams);
+            Func(Solver);
+            break;
+        }
+        case IntegratorType::PointMass3D:
+        {
+            PointMass3DSolver<TDragTable> Solver(InDragTable, InFiringData, Environment, InSolverParams);
+            Func(Solver);
+            break;
+        }
+        case IntegratorType::HybridEulerRk4:
+        default:
+        {
+            HybridEulerRk4Solver<TDragTable> Solver(InDragTable, InFiringData, Environment, InSolverParams);
+            Func(Solver);
+            break;
+        }
+        }
+    }
+}
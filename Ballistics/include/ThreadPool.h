@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Ballistics
+{
+    /**
+     * @brief Fixed size thread pool executing indexed tasks with work stealing.
+     *
+     * ParallelFor splits the index range into one contiguous chunk per worker queue; each worker pops from the back
+     * of its own queue and, once that is empty, steals from the front of the others, so uneven task costs (e.g. slow
+     * subsonic trajectories next to fast ones) still balance across all cores. The calling thread works as well.
+     * Calls to ParallelFor from different threads run one after the other; a task must not call ParallelFor on the
+     * pool running it, which would wait on itself.
+     */
+    class WorkStealingPool
+    {
+    public:
+        using TaskType = std::function<void(size_t TaskIndex)>;
+
+        // NumThreads == 0 uses all hardware threads
+        explicit WorkStealingPool(size_t NumThreads = 0);
+        ~WorkStealingPool();
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        size_t GetNumThreads() const
+        {
+            return Queues.size();
+        }
+
+        // run Task(n) for n in [0, NumTasks) and block until all have completed
+        void ParallelFor(size_t NumTasks, const TaskType& Task);
+
+    private:
+        struct WorkQueue
+        {
+            std::mutex Mutex;
+            std::deque<size_t> Tasks;
+        };
+
+        void WorkerLoop(size_t WorkerIndex);
+        bool RunOne(size_t WorkerIndex);
+
+        std::vector<std::unique_ptr<WorkQueue>> Queues;
+        std::vector<std::thread> Workers;
+
+        // held for the whole of a ParallelFor, the task, the count and the queues belong to one call at a time
+        std::mutex CallMutex;
+        std::mutex Mutex;
+        std::condition_variable WakeCondition;
+        std::condition_variable DoneCondition;
+        const TaskType* CurrentTask = nullptr;
+        std::atomic<size_t> RemainingTasks = 0;
+        uint64_t Generation = 0;
+        bool bStopping = false;
+    };
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <optional>
+#include <span>
+#include <vector>
+#include "Ballistics.h"
+
+namespace Ballistics
+{
+    /**
+     * @brief A trajectory point with the kinetic energy of the bullet at that point.
+     */
+    struct TrajectorySample
+    {
+        TrajectoryDataPoint Point;
+        float EnergyJ = 0.0f;
+    };
+
+    /**
+     * @brief Compact interpolant over a solved trajectory, answering queries by downrange distance or by time.
+     *
+     * The trajectory points are kept as structure-of-arrays; between two points the position is a cubic Hermite
+     * segment using the velocities as tangents, and the velocity is its derivative. Queries by X are a binary search,
+     * queries by T are O(1) when the points are uniformly spaced in time (fixed step solvers) and a binary search
+     * otherwise. One solve can then answer any number of "what is the drop at 437m" questions.
+     */
+    class TrajectoryTable
+    {
+    public:
+        TrajectoryTable() = default;
+        TrajectoryTable(std::span<const TrajectoryDataPoint> InPoints, float InMassKg)
+        {
+            Build(InPoints, InMassKg);
+        }
+
+        /**
+         * @param InPoints trajectory in time order, e.g. from SolveTrajectory with the muzzle point first
+         * @param InMassKg bullet mass, for energy
+         */
+        void Build(std::span<const TrajectoryDataPoint> InPoints, float InMassKg);
+
+        bool IsEmpty() const
+        {
+            return T.size() < 2;
+        }
+
+        size_t Size() const
+        {
+            return T.size();
+        }
+
+        float GetMinX() const { return X.front(); }
+        float GetMaxX() const { return X.back(); }
+        float GetMinT() const { return T.front(); }
+        float GetMaxT() const { return T.back(); }
+
+        // sample at downrange distance InX, or nullopt if outside the trajectory
+        std::optional<TrajectorySample> AtX(float InX) const;
+        // sample at time InT, or nullopt if outside the trajectory
+        std::optional<TrajectorySample> AtT(float InT) const;
+
+    private:
+        size_t FindSegmentByX(float InX) const;
+        size_t FindSegmentByT(float InT) const;
+        TrajectorySample Evaluate(size_t Segment, float Theta) const;
+
+        std::vector<float> T;
+        std::vector<float> X;
+        std::vector<float> Y;
+        std::vector<float> Vx;
+        std::vector<float> Vy;
+        float MassKg = 0.0f;
+        // non-zero if the points are uniformly spaced in time
+        float InvUniformTimeStep = 0.0f;
+    };
+
+    /**
+     * Calculate trajectory of projectile into an interpolant, which includes the muzzle point
+     */
+    void SolveTrajectory(const DragTableType& InDragTable, TrajectoryTable& OutTrajectoryTable, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& Solver);
+    void SolveTrajectory(const CompiledDragTable& InDragTable, TrajectoryTable& OutTrajectoryTable, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& Solver);
+}
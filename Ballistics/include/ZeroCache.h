@@ -0,0 +1,102 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include "Ballistics.h"
+
+namespace Ballistics
+{
+    /**
+     * Quantisation steps for the zero cache key; inputs that differ by less than a step share a zero angle
+     */
+    struct ZeroCacheQuantisation
+    {
+        float BallisticCoefficient = 0.0001f;
+        float MassGr = 0.1f;
+        float CallibreMm = 0.001f;
+        float MuzzleVelocityMs = 0.1f;
+        float ZeroDistance = 0.01f;
+        float TKelvin = 0.1f;
+        float AirDensity = 0.0001f;
+        float Gravity = 0.0001f;
+        float ToleranceM = 0.00001f;
+        float TimeStep = 0.00001f;
+        float MaxTime = 0.001f;
+    };
+
+    /**
+     * @brief Bounded LRU cache of zero angles.
+     *
+     * The key is the quantised bullet ballistics (BCs, mass, callibre), muzzle velocity, zero distance, the environment
+     * (temperature, air density, gravity), the zeroing parameters and a hash of the drag table contents, so the same load
+     * zeroed again under the same, or nearly the same, conditions is a lookup instead of a solve. Only converged
+     * zeroings are cached, and on a hit the cached angle is the one solved for the inputs that first populated the entry.
+     * Lookups are guarded by a mutex so one cache can be shared between threads; the zeroing itself runs unlocked.
+     */
+    class ZeroCache
+    {
+    public:
+        explicit ZeroCache(size_t InCapacity = 256, const ZeroCacheQuantisation& InQuantisation = {})
+            : Capacity(InCapacity > 0 ? InCapacity : 1),
+            Quantisation(InQuantisation)
+        {
+        }
+
+        ZeroCache(const ZeroCache&) = delete;
+        ZeroCache& operator=(const ZeroCache&) = delete;
+
+        /**
+         * As FiringData::ZeroIn, a cache hit sets the ZeroAngle and returns the cached result with zero iterations and steps.
+         * Compiled tables only, they carry the content hash the key needs so a lookup doesn't walk the table
+         */
+        ZeroingResult ZeroIn(FiringData& InOutFiringData, const CompiledDragTable& InDragTable, float ToleranceM, const EnvironmentData& Environment, const ZeroingParams& Params = {});
+
+        void Clear();
+
+        size_t Size() const;
+        size_t GetCapacity() const
+        {
+            return Capacity;
+        }
+        uint64_t GetHits() const;
+        uint64_t GetMisses() const;
+
+    private:
+        struct Key
+        {
+            std::array<int32_t, 13> Values{};
+            // CompiledDragTable::ContentHash, not the address: a table compiled into the slot of a previous one is a different key
+            uint64_t DragTableHash = 0;
+
+            bool operator==(const Key&) const = default;
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const Key& InKey) const;
+        };
+
+        struct Entry
+        {
+            Key CacheKey;
+            float ZeroAngle = 0.0f;
+            ZeroingResult Result;
+        };
+
+        Key MakeKey(const FiringData& InFiringData, uint64_t InDragTableHash, float ToleranceM, const EnvironmentData& Environment, const ZeroingParams& Params) const;
+        bool Find(const Key& InKey, float& OutZeroAngle, ZeroingResult& OutResult);
+        void Insert(const Key& InKey, float InZeroAngle, const ZeroingResult& InResult);
+
+        const size_t Capacity;
+        const ZeroCacheQuantisation Quantisation;
+
+        mutable std::mutex Mutex;
+        // most recently used first
+        std::list<Entry> Entries;
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> Index;
+        uint64_t Hits = 0;
+        uint64_t Misses = 0;
+    };
+}
@@ -1,123 +1,90 @@
 
 #include "Ballistics.h"
-#include "Solver.h"
+#include "SolverEngines.h"
 #include "Data.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <map>
 #include <numbers>
-#include <functional>
 #include <array>
 
 namespace Ballistics
 {
-    struct SolverBase
-    {
-        virtual ~SolverBase() = default;
-        TrajectoryDataPoint Q;
-        float DragFactor;
-        EnvironmentData Environment;
-        SolverParams Params;
-        const DragTableType& DragTable;
-
-        SolverBase(const DragTableType& InDragTable, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& SolverParams)
-            : Q(InFiringData),
-            DragFactor(0.5f * Environment.AirDensity * InFiringData.Bullet.GetCrossSectionalArea() / InFiringData.Bullet.GetMassKg()),
-            Environment(Environment),
-            Params(SolverParams),
-            DragTable(InDragTable)
-        {
-        }
-        virtual bool Completed() const
-        {
-            return Q.T >= Params.MaxTime || Q.Position.GetY() < 0.0f;
-        }
-        virtual bool Terminated() const
-        {
-            return Q.T >= Params.MaxTime;
-        }
-        virtual void Reset(const FiringData& InFiringData)
-        {
-            Q.Initialize(InFiringData);
-        }
-        virtual void Advance() = 0;
-    };
+    template<typename TDragTable, typename TSink>
+	void SolveTrajectoryImpl(const TDragTable& InDragTable, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& InSolverParams, TSink&& Sink)
+	{
+        WithSolverEngine(InDragTable, InFiringData, Environment, InSolverParams, [&Sink](auto& Solver)
+            {
+                Solver.Integrate(Sink);
+            });
+	}
 
-    struct HybridEulerRk4Solver : SolverBase
+    template<typename TDragTable>
+    void SolveTrajectoryToVector(const TDragTable& InDragTable, std::vector<TrajectoryDataPoint>& OutElevation, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& InSolverParams)
     {
-        HybridEulerRk4Solver(const DragTableType& InDragTable, const FiringData& InFiringData, const EnvironmentData& InEnvironment, const SolverParams& SolverParams)
-            : SolverBase(InDragTable, InFiringData, InEnvironment, SolverParams)
-        {
-            LastQ = { InFiringData.MuzzleVelocityMs * cosf(InFiringData.ZeroAngle), InFiringData.MuzzleVelocityMs * sinf(InFiringData.ZeroAngle) };
-            
-            VelocitySolver.Initialize(InFiringData.MuzzleVelocityMs, SolverParams.TimeStep, [this](float V, float /* t */) -> float
-                {
-                    return -DragFactor * GetDragCoefficient(DragTable,V, this->Environment.TKelvin) * (V * V);
-                });
-        }
-
-        virtual void Advance() override
-        {
-            const float FlightVelocity = VelocitySolver.Advance();
-            const float AngleOfAttack = std::atan2f(LastQ.GetY(), LastQ.GetX());
-            
-            Q.Velocity = {FlightVelocity*std::cosf(AngleOfAttack), FlightVelocity*std::sinf(AngleOfAttack) + Environment.Gravity * Params.TimeStep};
-            Q.Position += Params.TimeStep * Q.Velocity;
-            LastQ = Q.Velocity;
-            Q.T += Params.TimeStep;
-        }
+        SolveTrajectoryImpl(InDragTable, InFiringData, Environment, InSolverParams, [&OutElevation](const TrajectoryDataPoint& Point)
+            {
+                OutElevation.emplace_back(Point);
+                return true;
+            });
+    }
 
-        void Reset(const FiringData& InFiringData) override
+    template<typename TDragTable>
+    size_t SolveTrajectoryToSpan(const TDragTable& InDragTable, std::span<TrajectoryDataPoint> OutElevation, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& InSolverParams)
+    {
+        size_t NumPoints = 0;
+        if (OutElevation.empty())
         {
-            SolverBase::Reset(InFiringData);
-            VelocitySolver.Reset();
-            LastQ.SetX(InFiringData.MuzzleVelocityMs * cosf(InFiringData.ZeroAngle));
-            LastQ.SetY(InFiringData.MuzzleVelocityMs * sinf(InFiringData.ZeroAngle));
+            return NumPoints;
         }
+        SolveTrajectoryImpl(InDragTable, InFiringData, Environment, InSolverParams, [&OutElevation, &NumPoints](const TrajectoryDataPoint& Point)
+            {
+                OutElevation[NumPoints++] = Point;
+                return NumPoints < OutElevation.size();
+            });
+        return NumPoints;
+    }
 
-        Solver::RungeKutta4 VelocitySolver;
-        Algebra::Vector2D LastQ;
-    };
-    
-	void SolveTrajectory(const DragTableType& InDragTable, std::vector<TrajectoryDataPoint>& OutElevation, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& InSolverParams)
-	{
-        HybridEulerRk4Solver Solver(InDragTable, InFiringData, Environment, InSolverParams);
-
-        while (!Solver.Completed() && (InSolverParams.MaxX==0.0f || Solver.Q.Position.GetX()<InSolverParams.MaxX))
-        {            
-            Solver.Advance();
-            OutElevation.emplace_back(Solver.Q);
-        }
-	}
-
-    void FiringData::ZeroIn(const DragTableType& InDragTable, float ToleranceM, const EnvironmentData& Environment)
+    /**
+     * Both methods fire from ToleranceM above y = 0 and aim for y = 0 at the zero distance, the residual is the height
+     * there. Bisects the launch angle between InMinAngle, which must fall short, and InMaxAngle
+     */
+    template<typename TDragTable>
+    ZeroingResult ZeroInBisection(FiringData& InOutFiringData, const TDragTable& InDragTable, float ToleranceM, const EnvironmentData& Environment, const ZeroingParams& Params,
+        float InMinAngle = 0.0f, float InMaxAngle = static_cast<float>(std::numbers::pi) / 2.0f)
     {
-        if (ZeroDistance <= 0.0f)
-        {
-            return;
-        }
+        float& ZeroDistance = InOutFiringData.ZeroDistance;
+        float& ZeroAngle = InOutFiringData.ZeroAngle;
+        float& Height = InOutFiringData.Height;
 
 	    SolverParams SolverParams;
-        SolverParams.MaxTime = 10.0f;
-        SolverParams.TimeStep = 0.01f;
+        SolverParams.MaxTime = Params.MaxTime;
+        SolverParams.TimeStep = Params.TimeStep;
 
         const float PrevHeight = Height;
         Height = ToleranceM;
-        float MinAngle = 0.0f;
-        float MaxAngle = static_cast<float>(std::numbers::pi) / 2.0f;
+        float MinAngle = InMinAngle;
+        float MaxAngle = InMaxAngle;
 	    ZeroAngle = MinAngle + (MaxAngle - MinAngle) / 2.0f;
 	    
-	    HybridEulerRk4Solver Solver(InDragTable, *this, Environment, SolverParams);
-        for (;;)
+        ZeroingResult Result;
+	    HybridEulerRk4Solver<TDragTable> Solver(InDragTable, InOutFiringData, Environment, SolverParams);
+        while (Result.Iterations < Params.MaxIterations)
         {
             ZeroAngle = MinAngle + (MaxAngle - MinAngle) / 2.0f;
-            Solver.Reset(*this);
+            Solver.Reset(InOutFiringData);
+            ++Result.Iterations;
 
             while (!Solver.Completed()
                 &&
                 Solver.Q.Position.GetX() < ZeroDistance-ToleranceM)
             {
                 Solver.Advance();
+                ++Result.SolverSteps;
             }
+            Result.ResidualM = Solver.Q.Position.GetY();
 
             // definite miss?
             if (fabsf(Solver.Q.Position.GetY()) > ToleranceM
@@ -138,18 +105,182 @@ namespace Ballistics
                 continue;
             }
 
-            // within target "box"?
-            if (Solver.Q.Position.GetX() >= ZeroDistance - ToleranceM
-                &&
-                Solver.Q.Position.GetX() <= ZeroDistance + ToleranceM
-                )
+            Result.bConverged = true;
+            break;
+        }
+        // reset to the original height
+        Height = PrevHeight;
+        return Result;
+    }
+
+    /**
+     * Height at InFiringData.ZeroDistance above y = 0, integrating only as far as the zero distance and interpolating
+     * between the last two steps
+     * @return false if the trajectory doesn't reach the zero distance
+     */
+    template<typename TDragTable>
+    bool HeightAtZeroDistance(HybridEulerRk4Solver<TDragTable>& Solver, const FiringData& InFiringData, float& OutHeight, size_t& InOutSolverSteps)
+    {
+        Solver.Reset(InFiringData);
+        TrajectoryDataPoint PrevQ = Solver.Q;
+        while (!Solver.Completed() && Solver.Q.Position.GetX() < InFiringData.ZeroDistance)
+        {
+            PrevQ = Solver.Q;
+            Solver.Advance();
+            ++InOutSolverSteps;
+        }
+        if (Solver.Q.Position.GetX() < InFiringData.ZeroDistance)
+        {
+            return false;
+        }
+        const float Scale = (InFiringData.ZeroDistance - PrevQ.Position.GetX()) / (Solver.Q.Position.GetX() - PrevQ.Position.GetX());
+        OutHeight = PrevQ.Position.GetY() + Scale * (Solver.Q.Position.GetY() - PrevQ.Position.GetY());
+        return true;
+    }
+
+    template<typename TDragTable>
+    ZeroingResult ZeroInSecant(FiringData& InOutFiringData, const TDragTable& InDragTable, float ToleranceM, const EnvironmentData& Environment, const ZeroingParams& Params)
+    {
+        float& ZeroAngle = InOutFiringData.ZeroAngle;
+        float& Height = InOutFiringData.Height;
+        const float ZeroDistance = InOutFiringData.ZeroDistance;
+
+        SolverParams SolverParams;
+        SolverParams.MaxTime = Params.MaxTime;
+        SolverParams.TimeStep = Params.TimeStep;
+        // the residual is signed, the trajectory must not stop when it goes below the muzzle
+        SolverParams.MinY = std::numeric_limits<float>::lowest();
+
+        // the same residual as the bisection
+        const float PrevHeight = Height;
+        Height = ToleranceM;
+
+        // angles known to fall short and to overshoot
+        float MinAngle = 0.0f;
+        float MaxAngle = static_cast<float>(std::numbers::pi) / 2.0f;
+
+        ZeroingResult Result;
+        HybridEulerRk4Solver<TDragTable> Solver(InDragTable, InOutFiringData, Environment, SolverParams);
+        const auto Trial = [&](float Angle, float& OutResidual)
             {
-                // done, reset to the original height
-                Height = PrevHeight;
+                ZeroAngle = Angle;
+                ++Result.Iterations;
+                if (!HeightAtZeroDistance(Solver, InOutFiringData, OutResidual, Result.SolverSteps))
+                {
+                    return false;
+                }
+                Result.ResidualM = OutResidual;
+                if (OutResidual < 0.0f)
+                {
+                    MinAngle = std::max(MinAngle, Angle);
+                }
+                else
+                {
+                    MaxAngle = std::min(MaxAngle, Angle);
+                }
+                return true;
+            };
+
+        // fired along the line of sight the residual is the drop, and for small angles raising the bore by Angle
+        // raises the impact by roughly ZeroDistance * Angle
+        float Angle0 = 0.0f;
+        float Residual0 = 0.0f;
+        bool bSecant = Trial(Angle0, Residual0);
+        float Angle1 = -Residual0 / ZeroDistance;
+        float Residual1 = Residual0;
+
+        while (bSecant && std::fabs(Result.ResidualM) > ToleranceM && Result.Iterations < Params.MaxIterations)
+        {
+            // a step out of the bracket or a growing residual means the secant isn't converging
+            if (!(Angle1 > MinAngle && Angle1 < MaxAngle)
+                ||
+                !Trial(Angle1, Residual1)
+                ||
+                std::fabs(Residual1) >= std::fabs(Residual0))
+            {
+                bSecant = false;
                 break;
             }
-            Height = PrevHeight;
-            break;
+
+            const float Angle2 = Angle1 - Residual1 * (Angle1 - Angle0) / (Residual1 - Residual0);
+            Angle0 = Angle1;
+            Residual0 = Residual1;
+            Angle1 = Angle2;
+        }
+        Height = PrevHeight;
+
+        if (bSecant)
+        {
+            Result.bConverged = std::fabs(Result.ResidualM) <= ToleranceM;
+            return Result;
+        }
+
+        // fall back to bisecting what is left of the bracket with what is left of the budget
+        ZeroingParams BisectionParams = Params;
+        BisectionParams.MaxIterations = std::max(Params.MaxIterations - Result.Iterations, 0);
+        const ZeroingResult BisectionResult = ZeroInBisection(InOutFiringData, InDragTable, ToleranceM, Environment, BisectionParams, MinAngle, MaxAngle);
+        Result.bConverged = BisectionResult.bConverged;
+        Result.Iterations += BisectionResult.Iterations;
+        Result.SolverSteps += BisectionResult.SolverSteps;
+        Result.ResidualM = BisectionResult.ResidualM;
+        return Result;
+    }
+
+    template<typename TDragTable>
+    ZeroingResult ZeroInImpl(FiringData& InOutFiringData, const TDragTable& InDragTable, float ToleranceM, const EnvironmentData& Environment, const ZeroingParams& Params)
+    {
+        if (InOutFiringData.ZeroDistance <= 0.0f)
+        {
+            return {};
+        }
+
+        switch (Params.Method)
+        {
+        case ZeroingMethod::Secant:
+            return ZeroInSecant(InOutFiringData, InDragTable, ToleranceM, Environment, Params);
+        case ZeroingMethod::Bisection:
+        default:
+            return ZeroInBisection(InOutFiringData, InDragTable, ToleranceM, Environment, Params);
         }
     }
+
+	void SolveTrajectory(const DragTableType& InDragTable, std::vector<TrajectoryDataPoint>& OutElevation, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& InSolverParams)
+	{
+        SolveTrajectoryToVector(InDragTable, OutElevation, InFiringData, Environment, InSolverParams);
+	}
+
+	void SolveTrajectory(const CompiledDragTable& InDragTable, std::vector<TrajectoryDataPoint>& OutElevation, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& InSolverParams)
+	{
+        SolveTrajectoryToVector(InDragTable, OutElevation, InFiringData, Environment, InSolverParams);
+	}
+
+    size_t SolveTrajectory(const DragTableType& InDragTable, std::span<TrajectoryDataPoint> OutElevation, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& InSolverParams)
+    {
+        return SolveTrajectoryToSpan(InDragTable, OutElevation, InFiringData, Environment, InSolverParams);
+    }
+
+    size_t SolveTrajectory(const CompiledDragTable& InDragTable, std::span<TrajectoryDataPoint> OutElevation, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& InSolverParams)
+    {
+        return SolveTrajectoryToSpan(InDragTable, OutElevation, InFiringData, Environment, InSolverParams);
+    }
+
+    void SolveTrajectory(const DragTableType& InDragTable, const TrajectorySink& Sink, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& InSolverParams)
+    {
+        SolveTrajectoryImpl(InDragTable, InFiringData, Environment, InSolverParams, Sink);
+    }
+
+    void SolveTrajectory(const CompiledDragTable& InDragTable, const TrajectorySink& Sink, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& InSolverParams)
+    {
+        SolveTrajectoryImpl(InDragTable, InFiringData, Environment, InSolverParams, Sink);
+    }
+
+    ZeroingResult FiringData::ZeroIn(const DragTableType& InDragTable, float ToleranceM, const EnvironmentData& Environment, const ZeroingParams& Params)
+    {
+        return ZeroInImpl(*this, InDragTable, ToleranceM, Environment, Params);
+    }
+
+    ZeroingResult FiringData::ZeroIn(const CompiledDragTable& InDragTable, float ToleranceM, const EnvironmentData& Environment, const ZeroingParams& Params)
+    {
+        return ZeroInImpl(*this, InDragTable, ToleranceM, Environment, Params);
+    }
 }
@@ -0,0 +1,169 @@
+#include "Ballistics.h"
+#include "Data.h"
+#include "DragKernel.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace Ballistics
+{
+    namespace
+    {
+        /**
+         * Structure-of-arrays state for a batch of trajectories, one entry per lane.
+         * Lanes that have completed keep their state, Active is 1.0f for lanes still being integrated and 0.0f otherwise
+         * so that the per-step loops can blend rather than branch.
+         */
+        struct BatchLanes
+        {
+            explicit BatchLanes(size_t NumLanes)
+                : X(NumLanes), Y(NumLanes), Vx(NumLanes), Vy(NumLanes), Speed(NumLanes), T(NumLanes),
+                DragFactor(NumLanes), InvSpeedOfSound(NumLanes), Gravity(NumLanes), Active(NumLanes),
+                K1(NumLanes), K2(NumLanes), K3(NumLanes), K4(NumLanes), Stage(NumLanes)
+            {
+            }
+
+            std::vector<float> X;
+            std::vector<float> Y;
+            std::vector<float> Vx;
+            std::vector<float> Vy;
+            std::vector<float> Speed;
+            std::vector<float> T;
+
+            std::vector<float> DragFactor;
+            std::vector<float> InvSpeedOfSound;
+            std::vector<float> Gravity;
+            std::vector<float> Active;
+
+            // RK4 scratch
+            std::vector<float> K1;
+            std::vector<float> K2;
+            std::vector<float> K3;
+            std::vector<float> K4;
+            std::vector<float> Stage;
+        };
+
+        /**
+         * OutK[n] = dV/dt at speed InSpeed[n], with the drag lookups done by the drag kernel in place. The vector paths
+         * only pay off on uniform tables, where they skip the grid; on the irregular G1 and G7 knots they are no faster
+         * than scalar lookups, and slower with SSE4.1
+         */
+        void EvaluateDrag(const CompiledDragTable& InDragTable, const BatchLanes& Lanes, const std::vector<float>& InSpeed, std::vector<float>& OutK)
+        {
+            const size_t NumLanes = InSpeed.size();
+            for (size_t n = 0; n < NumLanes; ++n)
+            {
+                OutK[n] = InSpeed[n] * Lanes.InvSpeedOfSound[n];
+            }
+            GetDragCoefficientsAtMach(InDragTable, OutK, OutK, InDragTable.UniformStep > 0.0f ? GetSupportedSimdLevel() : SimdLevel::Scalar);
+            for (size_t n = 0; n < NumLanes; ++n)
+            {
+                const float V = InSpeed[n];
+                OutK[n] = -Lanes.DragFactor[n] * OutK[n] * (V * V);
+            }
+        }
+
+        size_t UpdateActive(BatchLanes& Lanes, const SolverParams& InSolverParams)
+        {
+            const size_t NumLanes = Lanes.X.size();
+            const float MaxX = InSolverParams.MaxX == 0.0f ? std::numeric_limits<float>::max() : InSolverParams.MaxX;
+            size_t NumActive = 0;
+            for (size_t n = 0; n < NumLanes; ++n)
+            {
+                const bool bRunning = Lanes.T[n] < InSolverParams.MaxTime && Lanes.Y[n] >= InSolverParams.MinY && Lanes.X[n] < MaxX;
+                Lanes.Active[n] = (Lanes.Active[n] != 0.0f && bRunning) ? 1.0f : 0.0f;
+                NumActive += Lanes.Active[n] != 0.0f ? 1 : 0;
+            }
+            return NumActive;
+        }
+    }
+
+    void SolveTrajectoryBatch(const CompiledDragTable& InDragTable, std::span<std::vector<TrajectoryDataPoint>> OutTrajectories, std::span<const FiringData> InFiringData, std::span<const EnvironmentData> InEnvironments, const SolverParams& InSolverParams)
+    {
+        const size_t NumLanes = InFiringData.size();
+        assert(OutTrajectories.size() == NumLanes);
+        assert(InEnvironments.size() == 1 || InEnvironments.size() == NumLanes);
+        if (NumLanes == 0 || InEnvironments.empty())
+        {
+            return;
+        }
+
+        BatchLanes Lanes(NumLanes);
+        for (size_t n = 0; n < NumLanes; ++n)
+        {
+            const FiringData& Firing = InFiringData[n];
+            const EnvironmentData& Environment = InEnvironments[InEnvironments.size() == 1 ? 0 : n];
+            const TrajectoryDataPoint Q0(Firing);
+            Lanes.X[n] = Q0.Position.GetX();
+            Lanes.Y[n] = Q0.Position.GetY();
+            Lanes.Vx[n] = Q0.Velocity.GetX();
+            Lanes.Vy[n] = Q0.Velocity.GetY();
+            Lanes.Speed[n] = Firing.MuzzleVelocityMs;
+            Lanes.T[n] = 0.0f;
+            Lanes.DragFactor[n] = 0.5f * Environment.AirDensity * Firing.Bullet.GetCrossSectionalArea() / Firing.Bullet.GetMassKg();
+            Lanes.InvSpeedOfSound[n] = Environment.GetInvSpeedOfSound();
+            Lanes.Gravity[n] = Environment.Gravity;
+            Lanes.Active[n] = 1.0f;
+        }
+
+        const float h = InSolverParams.TimeStep;
+        const float HalfH = 0.5f * h;
+        const size_t OutputStepStride = std::max<size_t>(InSolverParams.OutputStepStride, 1);
+        size_t NumSteps = 0;
+        while (UpdateActive(Lanes, InSolverParams) > 0)
+        {
+            // RK4 on flight speed, as HybridEulerRk4Solver
+            EvaluateDrag(InDragTable, Lanes, Lanes.Speed, Lanes.K1);
+            for (size_t n = 0; n < NumLanes; ++n)
+            {
+                Lanes.Stage[n] = Lanes.Speed[n] + HalfH * Lanes.K1[n];
+            }
+            EvaluateDrag(InDragTable, Lanes, Lanes.Stage, Lanes.K2);
+            for (size_t n = 0; n < NumLanes; ++n)
+            {
+                Lanes.Stage[n] = Lanes.Speed[n] + HalfH * Lanes.K2[n];
+            }
+            EvaluateDrag(InDragTable, Lanes, Lanes.Stage, Lanes.K3);
+            for (size_t n = 0; n < NumLanes; ++n)
+            {
+                Lanes.Stage[n] = Lanes.Speed[n] + h * Lanes.K3[n];
+            }
+            EvaluateDrag(InDragTable, Lanes, Lanes.Stage, Lanes.K4);
+
+            // re-project speed onto the previous direction of flight and apply gravity, masked by Active
+            for (size_t n = 0; n < NumLanes; ++n)
+            {
+                const float Mask = Lanes.Active[n];
+                const float NewSpeed = Lanes.Speed[n] + (h / 6.0f) * (Lanes.K1[n] + 2.0f * Lanes.K2[n] + 2.0f * Lanes.K3[n] + Lanes.K4[n]);
+                // cos and sin of the angle of attack without the trigonometry
+                const float InvLength = 1.0f / std::sqrt(Lanes.Vx[n] * Lanes.Vx[n] + Lanes.Vy[n] * Lanes.Vy[n]);
+                const float NewVx = NewSpeed * Lanes.Vx[n] * InvLength;
+                const float NewVy = NewSpeed * Lanes.Vy[n] * InvLength + Lanes.Gravity[n] * h;
+
+                Lanes.Speed[n] += Mask * (NewSpeed - Lanes.Speed[n]);
+                Lanes.Vx[n] += Mask * (NewVx - Lanes.Vx[n]);
+                Lanes.Vy[n] += Mask * (NewVy - Lanes.Vy[n]);
+                Lanes.X[n] += Mask * h * Lanes.Vx[n];
+                Lanes.Y[n] += Mask * h * Lanes.Vy[n];
+                Lanes.T[n] += Mask * h;
+            }
+
+            if (++NumSteps % OutputStepStride != 0)
+            {
+                continue;
+            }
+            for (size_t n = 0; n < NumLanes; ++n)
+            {
+                if (Lanes.Active[n] != 0.0f)
+                {
+                    TrajectoryDataPoint& Q = OutTrajectories[n].emplace_back();
+                    Q.Position.Set(Lanes.X[n], Lanes.Y[n]);
+                    Q.Velocity.Set(Lanes.Vx[n], Lanes.Vy[n]);
+                    Q.T = Lanes.T[n];
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,235 @@
+#include "BulletCatalogue.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace Ballistics
+{
+    uint64_t StringPool::Hash(std::string_view String)
+    {
+        uint64_t Hash = 14695981039346656037ull;
+        for (const char C : String)
+        {
+            Hash = (Hash ^ static_cast<uint8_t>(C)) * 1099511628211ull;
+        }
+        return Hash;
+    }
+
+    uint32_t StringPool::Intern(std::string_view String)
+    {
+        uint32_t Id;
+        if (Find(String, Id))
+        {
+            return Id;
+        }
+        Id = static_cast<uint32_t>(Size());
+        Chars.append(String);
+        Offsets.push_back(static_cast<uint32_t>(Chars.size()));
+        if (2 * (Size() + 1) > Buckets.size())
+        {
+            Rehash(std::max<size_t>(16, 2 * Buckets.size()));
+        }
+        else
+        {
+            const size_t Mask = Buckets.size() - 1;
+            size_t Bucket = Hash(String) & Mask;
+            while (Buckets[Bucket] != 0)
+            {
+                Bucket = (Bucket + 1) & Mask;
+            }
+            Buckets.Mutable(Bucket) = Id + 1;
+        }
+        return Id;
+    }
+
+    bool StringPool::Find(std::string_view String, uint32_t& OutId) const
+    {
+        if (Buckets.empty())
+        {
+            return false;
+        }
+        const size_t Mask = Buckets.size() - 1;
+        for (size_t Bucket = Hash(String) & Mask; Buckets[Bucket] != 0; Bucket = (Bucket + 1) & Mask)
+        {
+            if (Get(Buckets[Bucket] - 1) == String)
+            {
+                OutId = Buckets[Bucket] - 1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void StringPool::Rehash(size_t NumBuckets)
+    {
+        std::vector<uint32_t> NewBuckets(NumBuckets, 0);
+        const size_t Mask = NumBuckets - 1;
+        for (uint32_t Id = 0; Id < Size(); ++Id)
+        {
+            size_t Bucket = Hash(Get(Id)) & Mask;
+            while (NewBuckets[Bucket] != 0)
+            {
+                Bucket = (Bucket + 1) & Mask;
+            }
+            NewBuckets[Bucket] = Id + 1;
+        }
+        Buckets = std::move(NewBuckets);
+    }
+
+    void StringPool::Clear()
+    {
+        Chars.clear();
+        Offsets = std::vector<uint32_t>{0};
+        Buckets.clear();
+    }
+
+    size_t BulletCatalogue::Add(const BulletData& InBullet)
+    {
+        CallibreMm.push_back(InBullet.CallibreMm);
+        MassGr.push_back(InBullet.MassGr);
+        G1BC.push_back(InBullet.G1BC);
+        G7BC.push_back(InBullet.G7BC);
+        CompanyId.push_back(Strings.Intern(InBullet.Company));
+        NameId.push_back(Strings.Intern(InBullet.Name));
+        DescriptionId.push_back(Strings.Intern(InBullet.Description));
+        bIndexed = false;
+        return Size() - 1;
+    }
+
+    void BulletCatalogue::Add(std::span<const BulletData> InBullets)
+    {
+        const size_t NewSize = Size() + InBullets.size();
+        for (FlatArray<float>* Field : {&CallibreMm, &MassGr, &G1BC, &G7BC})
+        {
+            Field->reserve(NewSize);
+        }
+        for (FlatArray<uint32_t>* Field : {&CompanyId, &NameId, &DescriptionId})
+        {
+            Field->reserve(NewSize);
+        }
+        for (const BulletData& Bullet : InBullets)
+        {
+            Add(Bullet);
+        }
+    }
+
+    void BulletCatalogue::Clear()
+    {
+        for (FlatArray<float>* Field : {&CallibreMm, &MassGr, &G1BC, &G7BC})
+        {
+            Field->clear();
+        }
+        for (FlatArray<uint32_t>* Field : {&CompanyId, &NameId, &DescriptionId})
+        {
+            Field->clear();
+        }
+        Strings.Clear();
+        Indices = {};
+        bIndexed = false;
+    }
+
+    void BulletCatalogue::BuildIndices()
+    {
+        const auto Fields = FieldArrays();
+        for (size_t nField = 0; nField < NumIndexFields; ++nField)
+        {
+            const FlatArray<float>& Values = *Fields[nField];
+            std::vector<uint32_t> Order(Size());
+            std::iota(Order.begin(), Order.end(), 0u);
+            // stable so that equal values stay in catalogue order
+            std::stable_sort(Order.begin(), Order.end(), [&Values](uint32_t a, uint32_t b)
+                {
+                    return Values[a] < Values[b];
+                });
+            std::vector<float> Keys(Size());
+            for (size_t n = 0; n < Size(); ++n)
+            {
+                Keys[n] = Values[Order[n]];
+            }
+            Indices[nField].Order = std::move(Order);
+            Indices[nField].Keys = std::move(Keys);
+        }
+        bIndexed = true;
+    }
+
+    BulletData BulletCatalogue::GetBullet(size_t Index) const
+    {
+        BulletData Bullet;
+        Bullet.CallibreMm = CallibreMm[Index];
+        Bullet.MassGr = MassGr[Index];
+        Bullet.G1BC = G1BC[Index];
+        Bullet.G7BC = G7BC[Index];
+        Bullet.Company = GetCompany(Index);
+        Bullet.Name = GetName(Index);
+        Bullet.Description = GetDescription(Index);
+        return Bullet;
+    }
+
+    bool BulletCatalogue::Matches(const BulletQuery& InQuery, bool bAnyCompany, uint32_t Company, size_t Index) const
+    {
+        return InQuery.CallibreMm.Contains(CallibreMm[Index])
+            && InQuery.MassGr.Contains(MassGr[Index])
+            && InQuery.G1BC.Contains(G1BC[Index])
+            && InQuery.G7BC.Contains(G7BC[Index])
+            && (bAnyCompany || CompanyId[Index] == Company);
+    }
+
+    void BulletCatalogue::Query(const BulletQuery& InQuery, std::vector<uint32_t>& OutIndices) const
+    {
+        OutIndices.clear();
+        const bool bAnyCompany = InQuery.Company.empty();
+        uint32_t Company = 0;
+        if (!bAnyCompany && !Strings.Find(InQuery.Company, Company))
+        {
+            return;
+        }
+
+        if (!bIndexed)
+        {
+            for (size_t n = 0; n < Size(); ++n)
+            {
+                if (Matches(InQuery, bAnyCompany, Company, n))
+                {
+                    OutIndices.push_back(static_cast<uint32_t>(n));
+                }
+            }
+            return;
+        }
+
+        // the candidates are the bullets in range of the bounded field with the fewest of them
+        const FloatRange Ranges[NumIndexFields] = {InQuery.CallibreMm, InQuery.MassGr, InQuery.G1BC, InQuery.G7BC};
+        size_t First = 0;
+        size_t Last = Size();
+        const SortedIndex* Candidates = &Indices[0];
+        for (size_t nField = 0; nField < NumIndexFields; ++nField)
+        {
+            if (!Ranges[nField].IsBounded())
+            {
+                continue;
+            }
+            const FlatArray<float>& Keys = Indices[nField].Keys;
+            const size_t Lower = static_cast<size_t>(std::lower_bound(Keys.begin(), Keys.end(), Ranges[nField].Min) - Keys.begin());
+            const size_t Upper = static_cast<size_t>(std::upper_bound(Keys.begin(), Keys.end(), Ranges[nField].Max) - Keys.begin());
+            if (Upper <= Lower)
+            {
+                return;
+            }
+            if (Upper - Lower < Last - First)
+            {
+                First = Lower;
+                Last = Upper;
+                Candidates = &Indices[nField];
+            }
+        }
+
+        for (size_t n = First; n < Last; ++n)
+        {
+            const uint32_t Index = Candidates->Order[n];
+            if (Matches(InQuery, bAnyCompany, Company, Index))
+            {
+                OutIndices.push_back(Index);
+            }
+        }
+        std::sort(OutIndices.begin(), OutIndices.end());
+    }
+}
@@ -1,86 +1,240 @@
 ﻿#include "BulletData.h"
-#include <sstream>
+#include "JsonReader.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
 
 namespace Ballistics
 {
     namespace
     {
-        // trim leading whitespace *and* opening and closing brackets
-        std::string Trim(const std::string& str) {
-            size_t start = str.find_first_not_of(" \t\n\r{");
-            if (start == std::string::npos) return "";
-    
-            size_t end = str.find_last_not_of(" \t\n\r}");
-            return str.substr(start, end - start + 1);
-        }
-    }
-    
-    bool BulletData::ParseFromJsonString(const std::string& InJsonString)
-    {
-        std::string JsonString(Trim(InJsonString));
-        if ( JsonString.empty() )
+        constexpr float InchToMm = 25.4f;
+
+        std::string Unescape(std::string_view Raw)
         {
-            return false;
+            std::string Result;
+            Result.reserve(Raw.size());
+            for (size_t n = 0; n < Raw.size(); ++n)
+            {
+                if (Raw[n] != '\\' || n + 1 == Raw.size())
+                {
+                    Result += Raw[n];
+                    continue;
+                }
+                switch (const char C = Raw[++n])
+                {
+                case 'b': Result += '\b'; break;
+                case 'f': Result += '\f'; break;
+                case 'n': Result += '\n'; break;
+                case 'r': Result += '\r'; break;
+                case 't': Result += '\t'; break;
+                case 'u':
+                {
+                    uint32_t CodePoint = 0;
+                    if (n + 4 >= Raw.size() || std::from_chars(Raw.data() + n + 1, Raw.data() + n + 5, CodePoint, 16).ptr != Raw.data() + n + 5)
+                    {
+                        return Result;
+                    }
+                    n += 4;
+                    // surrogate pairs are kept as two code points, the catalogue has none
+                    if (CodePoint < 0x80)
+                    {
+                        Result += static_cast<char>(CodePoint);
+                    }
+                    else if (CodePoint < 0x800)
+                    {
+                        Result += static_cast<char>(0xC0 | (CodePoint >> 6));
+                        Result += static_cast<char>(0x80 | (CodePoint & 0x3F));
+                    }
+                    else
+                    {
+                        Result += static_cast<char>(0xE0 | (CodePoint >> 12));
+                        Result += static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F));
+                        Result += static_cast<char>(0x80 | (CodePoint & 0x3F));
+                    }
+                    break;
+                }
+                default:
+                    // \" \\ and \/
+                    Result += C;
+                    break;
+                }
+            }
+            return Result;
         }
-        
-        std::stringstream JsonStringStream(JsonString);
-        std::string Line;
-        while (std::getline(JsonStringStream, Line))
-        {
-            std::string Key, Value;
-            size_t DelimeterPos = Line.find(':');
-            if (DelimeterPos != std::string::npos)
-            {
-                Key = Trim(Line.substr(0, DelimeterPos));
-                const size_t NextDelimeterPos = Line.find(',', DelimeterPos + 1);
-                Value = NextDelimeterPos != std::string::npos ?
-                Trim(Line.substr(DelimeterPos + 1, NextDelimeterPos - DelimeterPos - 1))
-                :
-                Trim(Line.substr(DelimeterPos + 1, Line.size() - DelimeterPos - 1));
 
-                // strip leading and trailing "'s
-                Key = Key.substr(1, Key.size() - 2);
-                Value = Value.substr(1, Value.size() - 2);
-            }
-            else
+        // keeps OutValue if Text isn't a number; catalogue numbers are strings, e.g. "0.308"
+        void ParseNumber(std::string_view Text, float& OutValue, float Scale = 1.0f)
+        {
+            float Value;
+            const auto [Ptr, Error] = std::from_chars(Text.data(), Text.data() + Text.size(), Value);
+            if (Error == std::errc() && Ptr != Text.data())
             {
-                continue;
+                OutValue = Value * Scale;
             }
+        }
 
-            if ( Value.empty())
+        void SetField(BulletData& OutBullet, std::string_view Key, std::string_view Value, bool bEscaped)
+        {
+            if (Value.empty())
             {
-                continue;
+                return;
             }
-
+            const auto String = [Value, bEscaped]()
+                {
+                    return bEscaped ? Unescape(Value) : std::string(Value);
+                };
             if (Key == "product_name")
             {
-                Name = Value;
+                OutBullet.Name = String();
             }
             else if (Key == "description")
             {
-                Description = Value;
+                OutBullet.Description = String();
             }
             else if (Key == "company")
             {
-                Company = Value;
+                OutBullet.Company = String();
             }
             else if (Key == "diameter_in")
             {
-                CallibreMm = std::stof(Value) * 24.4f;
+                ParseNumber(Value, OutBullet.CallibreMm, InchToMm);
             }
             else if (Key == "weight_gr")
             {
-                MassGr = std::stof(Value);
+                ParseNumber(Value, OutBullet.MassGr);
             }
             else if (Key == "bc_g1")
             {
-                G1BC = std::stof(Value);
+                ParseNumber(Value, OutBullet.G1BC);
             }
             else if (Key == "bc_g7")
             {
-                G7BC = std::stof(Value);
+                ParseNumber(Value, OutBullet.G7BC);
+            }
+        }
+
+        bool ParseBulletObject(JsonReader& Reader, BulletData& OutBullet)
+        {
+            if (!Reader.Consume('{'))
+            {
+                return false;
+            }
+            if (Reader.Consume('}'))
+            {
+                return true;
+            }
+            do
+            {
+                std::string_view Key;
+                std::string_view Value;
+                bool bEscaped;
+                if (!Reader.ReadString(Key, bEscaped) || !Reader.Consume(':'))
+                {
+                    return false;
+                }
+                const char C = Reader.Peek();
+                if (C == '"')
+                {
+                    if (!Reader.ReadString(Value, bEscaped))
+                    {
+                        return false;
+                    }
+                    SetField(OutBullet, Key, Value, bEscaped);
+                }
+                else if (C == '-' || (C >= '0' && C <= '9'))
+                {
+                    SetField(OutBullet, Key, Reader.ReadScalar(), false);
+                }
+                else if (!Reader.SkipValue())
+                {
+                    return false;
+                }
+            } while (Reader.Consume(','));
+            return Reader.Consume('}');
+        }
+
+        bool ParseBulletCatalogueJsonImpl(std::string_view Json, std::vector<BulletData>& OutBullets)
+        {
+            JsonReader Reader(Json);
+            if (Reader.Peek() == '{')
+            {
+                if (!ParseBulletObject(Reader, OutBullets.emplace_back()))
+                {
+                    OutBullets.pop_back();
+                    return false;
+                }
+                return Reader.Peek() == '\0';
+            }
+            if (!Reader.Consume('['))
+            {
+                return false;
             }
+
+            // at most one bullet per opening brace, cheap to count and saves growing the vector
+            OutBullets.reserve(OutBullets.size() + static_cast<size_t>(std::count(Reader.It, Reader.End, '{')));
+            if (Reader.Consume(']'))
+            {
+                return Reader.Peek() == '\0';
+            }
+            do
+            {
+                if (!ParseBulletObject(Reader, OutBullets.emplace_back()))
+                {
+                    OutBullets.pop_back();
+                    return false;
+                }
+            } while (Reader.Consume(','));
+            return Reader.Consume(']') && Reader.Peek() == '\0';
+        }
+    }
+
+    bool BulletData::ParseFromJsonString(const std::string& InJsonString)
+    {
+        JsonReader Reader(InJsonString);
+        return ParseBulletObject(Reader, *this);
+    }
+
+    bool ParseBulletCatalogueJson(std::string_view Json, std::vector<BulletData>& OutBullets, BulletCatalogueLoadStats* OutStats)
+    {
+        const auto Start = std::chrono::steady_clock::now();
+        const size_t NumBullets = OutBullets.size();
+        const bool bParsed = ParseBulletCatalogueJsonImpl(Json, OutBullets);
+        if (OutStats)
+        {
+            OutStats->NumBytes = Json.size();
+            OutStats->NumBullets = OutBullets.size() - NumBullets;
+            OutStats->Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+        }
+        return bParsed;
+    }
+
+    bool LoadBulletCatalogueJson(const std::filesystem::path& Path, std::vector<BulletData>& OutBullets, BulletCatalogueLoadStats* OutStats)
+    {
+        return LoadBulletCatalogueJson(std::span(&Path, 1), OutBullets, OutStats);
+    }
+
+    bool LoadBulletCatalogueJson(std::span<const std::filesystem::path> Paths, std::vector<BulletData>& OutBullets, BulletCatalogueLoadStats* OutStats)
+    {
+        const auto Start = std::chrono::steady_clock::now();
+        const size_t NumBullets = OutBullets.size();
+        size_t NumBytes = 0;
+        bool bLoaded = true;
+        for (const std::filesystem::path& Path : Paths)
+        {
+            const MappedFile File(Path);
+            bLoaded &= File.IsOpen() && ParseBulletCatalogueJsonImpl(File.GetView(), OutBullets);
+            NumBytes += File.GetSize();
+        }
+        if (OutStats)
+        {
+            OutStats->NumBytes = NumBytes;
+            OutStats->NumBullets = OutBullets.size() - NumBullets;
+            OutStats->Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
         }
-        return true;
+        return bLoaded;
     }
 }
@@ -1,4 +1,8 @@
 ﻿#include "Data.h"
+#include "DragCurve.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
 
 /* Tables ported to C++ from https://github.com/dbookstaber/py_ballistics/blob/master/py_ballisticcalc/drag_tables.py */
 
@@ -179,17 +183,19 @@ namespace Ballistics
     {
     	float SpeedToMach(float SpeedMs, float TemperatureK)
     	{
-    		constexpr float Gamma = 1.4f;
-    		constexpr float R = 287.05f;
-    		return SpeedMs / sqrtf(Gamma * R * TemperatureK);
+    		return SpeedMs / GetSpeedOfSound(TemperatureK);
     	}
     }
 	
 	float GetDragCoefficient(const DragTableType& Table, float Speed, float TemperatureK)
 	{
-		Speed = SpeedToMach(Speed, TemperatureK);
-		//NOTE: returns first element >= Speed ("not less than")
-		DragTableType::const_iterator DragTableIter = Table.lower_bound(Speed);
+		return GetDragCoefficientAtMach(Table, SpeedToMach(Speed, TemperatureK));
+	}
+
+	float GetDragCoefficientAtMach(const DragTableType& Table, float Mach)
+	{
+		//NOTE: returns first element >= Mach ("not less than")
+		DragTableType::const_iterator DragTableIter = Table.lower_bound(Mach);
 		if (DragTableIter!=Table.end())
 		{
 			const auto UpperEntry = *DragTableIter;
@@ -198,9 +204,247 @@ namespace Ballistics
 			{
 				LowerEntry = *(--DragTableIter);
 			}
-			const float Scale = (Speed - LowerEntry.first) / (UpperEntry.first - LowerEntry.first);
+			const float Scale = (Mach - LowerEntry.first) / (UpperEntry.first - LowerEntry.first);
 			return LowerEntry.second + Scale*(UpperEntry.second - LowerEntry.second);
 		}
 		return 0.0f;
 	}
+
+	namespace
+	{
+		// upper bound on the number of grid cells, tables with very closely spaced knots fall back to a short scan
+		constexpr size_t MaxGridCells = 4096;
+
+		uint64_t HashWord(uint64_t Hash, uint32_t Word)
+		{
+			for (int n = 0; n < 4; ++n)
+			{
+				Hash = (Hash ^ ((Word >> (8 * n)) & 0xffu)) * 1099511628211ull;
+			}
+			return Hash;
+		}
+
+		uint64_t HashKnot(uint64_t Hash, float KnotMach, float KnotCd)
+		{
+			return HashWord(HashWord(Hash, std::bit_cast<uint32_t>(KnotMach)), std::bit_cast<uint32_t>(KnotCd));
+		}
+
+		uint64_t HashRules(uint64_t Hash, DragExtrapolation Extrapolation, DragInterpolation Interpolation)
+		{
+			return HashWord(HashWord(Hash, static_cast<uint32_t>(Extrapolation)), static_cast<uint32_t>(Interpolation));
+		}
+	}
+
+	uint64_t HashDragTable(const CompiledDragTable& Table)
+	{
+		uint64_t Hash = 14695981039346656037ull;
+		const size_t NumKnots = std::min(Table.Mach.size(), Table.Cd.size());
+		for (size_t n = 0; n < NumKnots; ++n)
+		{
+			Hash = HashKnot(Hash, Table.Mach[n], Table.Cd[n]);
+		}
+		return HashRules(Hash, Table.Extrapolation, Table.Interpolation);
+	}
+
+	CompiledDragTable::CompiledDragTable(const DragTableType& InTable)
+	{
+		std::vector<float> TableMach;
+		std::vector<float> TableCd;
+		TableMach.reserve(InTable.size());
+		TableCd.reserve(InTable.size());
+		for (const auto& [EntryMach, EntryCd] : InTable)
+		{
+			TableMach.push_back(EntryMach);
+			TableCd.push_back(EntryCd);
+		}
+		Mach = std::move(TableMach);
+		Cd = std::move(TableCd);
+		Compile();
+	}
+
+	CompiledDragTable::CompiledDragTable(std::span<const float> InMach, std::span<const float> InCd, const DragTableOptions& Options)
+		: Extrapolation(Options.Extrapolation), Interpolation(Options.Interpolation)
+	{
+		// left empty rather than compiling a grid from knots out of order
+		if (ValidateDragCurve(InMach, InCd) != DragCurveStatus::Ok)
+		{
+			return;
+		}
+		const size_t NumKnots = InMach.size();
+		if (Options.NumUniformKnots < 2)
+		{
+			Mach = std::vector<float>(InMach.begin(), InMach.end());
+			Cd = std::vector<float>(InCd.begin(), InCd.end());
+			Compile();
+			return;
+		}
+
+		std::vector<float> TableMach(Options.NumUniformKnots);
+		std::vector<float> TableCd(Options.NumUniformKnots);
+		const float Step = (InMach[NumKnots - 1] - InMach[0]) / static_cast<float>(Options.NumUniformKnots - 1);
+		size_t Segment = 0;
+		for (size_t n = 0; n < TableMach.size(); ++n)
+		{
+			// the last knot exactly, not as accumulated by the steps
+			const float KnotMach = n + 1 == TableMach.size() ? InMach[NumKnots - 1] : InMach[0] + static_cast<float>(n) * Step;
+			while (Segment + 2 < NumKnots && KnotMach > InMach[Segment + 1])
+			{
+				++Segment;
+			}
+			const float Scale = (KnotMach - InMach[Segment]) / (InMach[Segment + 1] - InMach[Segment]);
+			TableMach[n] = KnotMach;
+			TableCd[n] = InCd[Segment] + Scale * (InCd[Segment + 1] - InCd[Segment]);
+		}
+		Mach = std::move(TableMach);
+		Cd = std::move(TableCd);
+		Compile();
+	}
+
+	void CompiledDragTable::Compile()
+	{
+		ContentHash = HashDragTable(*this);
+		if (IsEmpty())
+		{
+			return;
+		}
+
+		const size_t NumSegments = Mach.size() - 1;
+		std::vector<float> TableSlope(NumSegments);
+		float MinSpacing = Mach.back() - Mach.front();
+		for (size_t n = 0; n < NumSegments; ++n)
+		{
+			const float Spacing = Mach[n + 1] - Mach[n];
+			TableSlope[n] = (Cd[n + 1] - Cd[n]) / Spacing;
+			MinSpacing = std::min(MinSpacing, Spacing);
+		}
+		if (Interpolation == DragInterpolation::MonotoneCubic)
+		{
+			CompileCubic(TableSlope);
+		}
+		Slope = std::move(TableSlope);
+
+		// one cell per smallest knot interval means a cell never spans more than two segments
+		const float MachRange = Mach.back() - Mach.front();
+		const size_t NumCells = std::min(static_cast<size_t>(std::ceil(MachRange / MinSpacing)), MaxGridCells) + 1;
+		GridInvStep = static_cast<float>(NumCells - 1) / MachRange;
+		std::vector<uint32_t> TableGridSegment(NumCells);
+		for (size_t n = 0; n < NumCells; ++n)
+		{
+			const float CellStart = Mach.front() + static_cast<float>(n) / GridInvStep;
+			const auto Upper = std::lower_bound(Mach.begin(), Mach.end(), CellStart);
+			const size_t Segment = Upper == Mach.begin() ? 0 : static_cast<size_t>(Upper - Mach.begin()) - 1;
+			TableGridSegment[n] = static_cast<uint32_t>(std::min(Segment, NumSegments - 1));
+		}
+		GridSegment = std::move(TableGridSegment);
+
+		// the same expression as the resampling, so that a resampled table is recognised exactly
+		const float Step = MachRange / static_cast<float>(NumSegments);
+		bool bUniform = true;
+		for (size_t n = 1; n < NumSegments && bUniform; ++n)
+		{
+			bUniform = Mach[n] == Mach.front() + static_cast<float>(n) * Step;
+		}
+		UniformStep = bUniform ? Step : 0.0f;
+	}
+
+	void CompiledDragTable::CompileCubic(const std::vector<float>& Secant)
+	{
+		// Fritsch-Carlson: the mean of the neighbouring secants, flat at extrema, then limited so that each segment
+		// stays monotone
+		const size_t NumSegments = Secant.size();
+		std::vector<float> Tangent(NumSegments + 1);
+		Tangent.front() = Secant.front();
+		Tangent.back() = Secant.back();
+		for (size_t n = 1; n < NumSegments; ++n)
+		{
+			Tangent[n] = Secant[n - 1] * Secant[n] > 0.0f ? 0.5f * (Secant[n - 1] + Secant[n]) : 0.0f;
+		}
+		for (size_t n = 0; n < NumSegments; ++n)
+		{
+			if (Secant[n] == 0.0f)
+			{
+				Tangent[n] = Tangent[n + 1] = 0.0f;
+				continue;
+			}
+			const float Alpha = Tangent[n] / Secant[n];
+			const float Beta = Tangent[n + 1] / Secant[n];
+			const float Radius2 = Alpha * Alpha + Beta * Beta;
+			if (Radius2 > 9.0f)
+			{
+				const float Tau = 3.0f / std::sqrt(Radius2);
+				Tangent[n] = Tau * Alpha * Secant[n];
+				Tangent[n + 1] = Tau * Beta * Secant[n];
+			}
+		}
+
+		// Hermite segments in power form around the left knot
+		std::vector<float> Coefficients(3 * NumSegments);
+		for (size_t n = 0; n < NumSegments; ++n)
+		{
+			const float InvSpacing = 1.0f / (Mach[n + 1] - Mach[n]);
+			Coefficients[3 * n] = Tangent[n];
+			Coefficients[3 * n + 1] = (3.0f * Secant[n] - 2.0f * Tangent[n] - Tangent[n + 1]) * InvSpacing;
+			Coefficients[3 * n + 2] = (Tangent[n] + Tangent[n + 1] - 2.0f * Secant[n]) * InvSpacing * InvSpacing;
+		}
+		Cubic = std::move(Coefficients);
+	}
+
+	float CompiledDragTable::GetAtMach(float InMach) const
+	{
+		if (IsEmpty())
+		{
+			return 0.0f;
+		}
+		// NaN takes this branch too, it must not reach the grid index
+		if (!(InMach <= Mach.back()))
+		{
+			switch (Extrapolation)
+			{
+			case DragExtrapolation::Clamp:
+				return Cd.back();
+			case DragExtrapolation::Linear:
+				return std::max(0.0f, Cd.back() + (InMach - Mach.back()) * Slope.back());
+			default:
+				return 0.0f;
+			}
+		}
+		if (InMach < Mach.front())
+		{
+			switch (Extrapolation)
+			{
+			case DragExtrapolation::Clamp:
+				return Cd.front();
+			case DragExtrapolation::Linear:
+				return std::max(0.0f, Cd.front() + (InMach - Mach.front()) * Slope.front());
+			default:
+				// a table starting at Mach 0 has nothing below it to scale down to
+				return Mach.front() > 0.0f ? InMach * (Cd.front() / Mach.front()) : Cd.front();
+			}
+		}
+
+		size_t Segment = GridSegment[static_cast<size_t>((InMach - Mach.front()) * GridInvStep)];
+		while (InMach > Mach[Segment + 1])
+		{
+			++Segment;
+		}
+		while (Segment > 0 && InMach < Mach[Segment])
+		{
+			--Segment;
+		}
+		const float Delta = InMach - Mach[Segment];
+		if (Interpolation == DragInterpolation::MonotoneCubic)
+		{
+			const float* Coefficients = &Cubic[3 * Segment];
+			return Cd[Segment] + Delta * (Coefficients[0] + Delta * (Coefficients[1] + Delta * Coefficients[2]));
+		}
+		return Cd[Segment] + Delta * Slope[Segment];
+	}
+
+	const CompiledDragTable CompiledG1(G1);
+	const CompiledDragTable CompiledG7(G7);
+
+	float GetDragCoefficient(const CompiledDragTable& Table, float Speed, float TemperatureK)
+	{
+		return Table.GetAtMach(SpeedToMach(Speed, TemperatureK));
+	}
 }
\ No newline at end of file
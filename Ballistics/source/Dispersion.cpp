@@ -0,0 +1,191 @@
+#include "Dispersion.h"
+#include "Random.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Ballistics
+{
+    namespace
+    {
+        // sums over one batch of samples, combined across batches in batch order
+        struct DispersionSums
+        {
+            size_t NumValid = 0;
+            size_t NumHits = 0;
+            double Y = 0.0;
+            double Z = 0.0;
+            double YY = 0.0;
+            double ZZ = 0.0;
+            double YZ = 0.0;
+            double Velocity = 0.0;
+            double TimeOfFlight = 0.0;
+            double Radius = 0.0;
+
+            void Add(const DispersionSums& Other)
+            {
+                NumValid += Other.NumValid;
+                NumHits += Other.NumHits;
+                Y += Other.Y;
+                Z += Other.Z;
+                YY += Other.YY;
+                ZZ += Other.ZZ;
+                YZ += Other.YZ;
+                Velocity += Other.Velocity;
+                TimeOfFlight += Other.TimeOfFlight;
+                Radius += Other.Radius;
+            }
+        };
+    }
+
+    bool DispersionTarget::Contains(float Y, float Z) const
+    {
+        const float dY = 2.0f * (Y - CentreYM) / HeightM;
+        const float dZ = 2.0f * (Z - CentreZM) / WidthM;
+        if (Shape == TargetShape::Rectangle)
+        {
+            return std::fabs(dY) <= 1.0f && std::fabs(dZ) <= 1.0f;
+        }
+        return dY * dY + dZ * dZ <= 1.0f;
+    }
+
+    DispersionImpact SolveDispersionSample(const CompiledDragTable& InDragTable, const FiringData& InFiringData, const EnvironmentData& Environment, const DispersionParams& Params, const DispersionTarget& Target, uint64_t SampleIndex)
+    {
+        // always draw every variable in the same order so that a sample doesn't depend on which SDs are zero
+        CounterRandom Random(Params.Seed, SampleIndex);
+        const float MuzzleVelocityError = Params.MuzzleVelocitySdMs * Random.NextGaussian();
+        const float BallisticCoefficientError = Params.BallisticCoefficientSd * Random.NextGaussian();
+        const float HeadWind = Params.HeadWindSdMs * Random.NextGaussian();
+        const float CrossWind = Params.CrossWindSdMs * Random.NextGaussian();
+        const float AimElevationError = Params.AimSdRad * Random.NextGaussian();
+        const float AimWindageError = Params.AimSdRad * Random.NextGaussian();
+
+        FiringData Firing = InFiringData;
+        Firing.MuzzleVelocityMs += MuzzleVelocityError;
+        Firing.ZeroAngle += Params.HoldElevationRad + AimElevationError;
+
+        // drag is proportional to air density over the ballistic coefficient, so scale the density rather than thread
+        // a drag factor through the solvers
+        EnvironmentData SampleEnvironment = Environment;
+        SampleEnvironment.AirDensity /= std::max(1.0f + BallisticCoefficientError, 0.1f);
+        SampleEnvironment.WindMs += Algebra::Vector3D(-HeadWind, 0.0f, CrossWind);
+
+        SolverParams Solver;
+        Solver.TimeStep = Params.TimeStep;
+        Solver.MaxTime = Params.MaxTime;
+        Solver.Integrator = Params.Integrator;
+        Solver.bCoriolis = Params.bCoriolis;
+        Solver.MaxX = Params.DistanceM;
+        Solver.MinY = std::numeric_limits<float>::lowest();
+        Solver.OutputDistanceStep = Params.DistanceM;
+
+        DispersionImpact Impact;
+        SolveTrajectory(InDragTable, [&](const TrajectoryDataPoint& Q)
+            {
+                Impact.YM = Q.Position.GetY() - Firing.Height;
+                // the solvers fire along X, a windage angle only moves the impact sideways
+                Impact.ZM = Q.Drift + Params.DistanceM * std::tan(Params.HoldWindageRad + AimWindageError);
+                Impact.VelocityMs = std::sqrt(Q.Velocity.LengthSq() + Q.DriftVelocity * Q.DriftVelocity);
+                Impact.TimeOfFlightS = Q.T;
+                Impact.bValid = true;
+                return false;
+            }, Firing, SampleEnvironment, Solver);
+        Impact.bHit = Impact.bValid && Target.Contains(Impact.YM, Impact.ZM);
+        return Impact;
+    }
+
+    DispersionResult SimulateDispersion(WorkStealingPool& Pool, const CompiledDragTable& InDragTable, const FiringData& InFiringData, const EnvironmentData& Environment, const DispersionParams& Params, const DispersionTarget& Target)
+    {
+        DispersionResult Result;
+        Result.NumSamples = Params.NumSamples;
+        if (Params.NumSamples == 0)
+        {
+            return Result;
+        }
+
+        // the batches are fixed by the parameters, not by the number of threads, so neither are the sums
+        const size_t BatchSize = std::max<size_t>(Params.BatchSize, 1);
+        const size_t NumBatches = (Params.NumSamples + BatchSize - 1) / BatchSize;
+        std::vector<DispersionImpact> Impacts(Params.NumSamples);
+        std::vector<DispersionSums> BatchSums(NumBatches);
+        Pool.ParallelFor(NumBatches, [&](size_t BatchIndex)
+            {
+                DispersionSums& Sums = BatchSums[BatchIndex];
+                const size_t End = std::min(Params.NumSamples, (BatchIndex + 1) * BatchSize);
+                for (size_t n = BatchIndex * BatchSize; n < End; ++n)
+                {
+                    const DispersionImpact& Impact = Impacts[n] = SolveDispersionSample(InDragTable, InFiringData, Environment, Params, Target, n);
+                    if (!Impact.bValid)
+                    {
+                        continue;
+                    }
+                    ++Sums.NumValid;
+                    Sums.NumHits += Impact.bHit ? 1 : 0;
+                    Sums.Y += Impact.YM;
+                    Sums.Z += Impact.ZM;
+                    Sums.YY += static_cast<double>(Impact.YM) * Impact.YM;
+                    Sums.ZZ += static_cast<double>(Impact.ZM) * Impact.ZM;
+                    Sums.YZ += static_cast<double>(Impact.YM) * Impact.ZM;
+                    Sums.Velocity += Impact.VelocityMs;
+                    Sums.TimeOfFlight += Impact.TimeOfFlightS;
+                }
+            });
+
+        DispersionSums Total;
+        for (const DispersionSums& Sums : BatchSums)
+        {
+            Total.Add(Sums);
+        }
+
+        Result.NumValid = Total.NumValid;
+        Result.NumHits = Total.NumHits;
+        const double HitProbability = static_cast<double>(Total.NumHits) / static_cast<double>(Params.NumSamples);
+        Result.HitProbability = static_cast<float>(HitProbability);
+        Result.HitProbabilityStdError = static_cast<float>(std::sqrt(HitProbability * (1.0 - HitProbability) / static_cast<double>(Params.NumSamples)));
+
+        if (Total.NumValid > 0)
+        {
+            const double InvNumValid = 1.0 / static_cast<double>(Total.NumValid);
+            const double MeanY = Total.Y * InvNumValid;
+            const double MeanZ = Total.Z * InvNumValid;
+            const double VarianceY = std::max(Total.YY * InvNumValid - MeanY * MeanY, 0.0);
+            const double VarianceZ = std::max(Total.ZZ * InvNumValid - MeanZ * MeanZ, 0.0);
+            const double CovarianceYZ = Total.YZ * InvNumValid - MeanY * MeanZ;
+            Result.MeanYM = static_cast<float>(MeanY);
+            Result.MeanZM = static_cast<float>(MeanZ);
+            Result.SdYM = static_cast<float>(std::sqrt(VarianceY));
+            Result.SdZM = static_cast<float>(std::sqrt(VarianceZ));
+            Result.CorrelationYZ = VarianceY > 0.0 && VarianceZ > 0.0 ? static_cast<float>(CovarianceYZ / std::sqrt(VarianceY * VarianceZ)) : 0.0f;
+            Result.MeanVelocityMs = static_cast<float>(Total.Velocity * InvNumValid);
+            Result.MeanTimeOfFlightS = static_cast<float>(Total.TimeOfFlight * InvNumValid);
+
+            // the radii need the centre, a second and much cheaper pass over the same batches
+            Pool.ParallelFor(NumBatches, [&](size_t BatchIndex)
+                {
+                    double Radius = 0.0;
+                    const size_t End = std::min(Params.NumSamples, (BatchIndex + 1) * BatchSize);
+                    for (size_t n = BatchIndex * BatchSize; n < End; ++n)
+                    {
+                        if (Impacts[n].bValid)
+                        {
+                            Radius += std::hypot(Impacts[n].YM - MeanY, Impacts[n].ZM - MeanZ);
+                        }
+                    }
+                    BatchSums[BatchIndex].Radius = Radius;
+                });
+            double Radius = 0.0;
+            for (const DispersionSums& Sums : BatchSums)
+            {
+                Radius += Sums.Radius;
+            }
+            Result.MeanRadiusM = static_cast<float>(Radius * InvNumValid);
+        }
+
+        if (Params.bKeepImpacts)
+        {
+            Result.Impacts = std::move(Impacts);
+        }
+        return Result;
+    }
+}
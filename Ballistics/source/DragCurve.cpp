@@ -0,0 +1,200 @@
+#include "DragCurve.h"
+#include "JsonReader.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace Ballistics
+{
+    namespace
+    {
+        bool ParseFloat(std::string_view Text, float& OutValue)
+        {
+            const auto [Ptr, Error] = std::from_chars(Text.data(), Text.data() + Text.size(), OutValue);
+            return Error == std::errc() && Ptr == Text.data() + Text.size();
+        }
+
+        bool IsSeparator(char C)
+        {
+            return C == ',' || C == ';' || C == ' ' || C == '\t' || C == '\r';
+        }
+
+        // the first two columns of Line
+        bool ParseCsvKnot(std::string_view Line, float& OutMach, float& OutCd)
+        {
+            std::string_view Columns[2];
+            size_t It = 0;
+            for (std::string_view& Column : Columns)
+            {
+                while (It < Line.size() && IsSeparator(Line[It]))
+                {
+                    ++It;
+                }
+                const size_t Start = It;
+                while (It < Line.size() && !IsSeparator(Line[It]))
+                {
+                    ++It;
+                }
+                Column = Line.substr(Start, It - Start);
+            }
+            return ParseFloat(Columns[0], OutMach) && ParseFloat(Columns[1], OutCd);
+        }
+
+        bool ParseJsonNumberArray(JsonReader& Reader, std::vector<float>& OutValues)
+        {
+            OutValues.clear();
+            if (!Reader.Consume('['))
+            {
+                return false;
+            }
+            if (Reader.Consume(']'))
+            {
+                return true;
+            }
+            do
+            {
+                std::string_view Text;
+                bool bEscaped;
+                if (Reader.Peek() == '"')
+                {
+                    if (!Reader.ReadString(Text, bEscaped))
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    Text = Reader.ReadScalar();
+                }
+                if (!ParseFloat(Text, OutValues.emplace_back()))
+                {
+                    return false;
+                }
+            } while (Reader.Consume(','));
+            return Reader.Consume(']');
+        }
+    }
+
+    DragCurveStatus ValidateDragCurve(std::span<const float> Mach, std::span<const float> Cd, size_t* OutKnot)
+    {
+        const auto Fail = [OutKnot](DragCurveStatus Status, size_t Knot)
+            {
+                if (OutKnot)
+                {
+                    *OutKnot = Knot;
+                }
+                return Status;
+            };
+        if (Mach.size() != Cd.size())
+        {
+            return Fail(DragCurveStatus::Malformed, std::min(Mach.size(), Cd.size()));
+        }
+        if (Mach.size() < 2)
+        {
+            return Fail(DragCurveStatus::TooFewKnots, Mach.size());
+        }
+        for (size_t n = 0; n < Mach.size(); ++n)
+        {
+            if (!std::isfinite(Mach[n]) || !std::isfinite(Cd[n]) || Mach[n] < 0.0f || Cd[n] < 0.0f)
+            {
+                return Fail(DragCurveStatus::InvalidValue, n);
+            }
+            if (n > 0 && Mach[n] <= Mach[n - 1])
+            {
+                return Fail(DragCurveStatus::NonMonotonicMach, n);
+            }
+        }
+        return DragCurveStatus::Ok;
+    }
+
+    DragCurveStatus ParseDragCurveCsv(std::string_view Csv, DragCurve& OutCurve)
+    {
+        OutCurve.Mach.clear();
+        OutCurve.Cd.clear();
+        if (Csv.starts_with("\xEF\xBB\xBF"))
+        {
+            Csv.remove_prefix(3);
+        }
+        bool bHeaderAllowed = true;
+        while (!Csv.empty())
+        {
+            const size_t LineEnd = std::min(Csv.find('\n'), Csv.size());
+            std::string_view Line = Csv.substr(0, LineEnd);
+            Csv.remove_prefix(std::min(LineEnd + 1, Csv.size()));
+            while (!Line.empty() && IsSeparator(Line.front()))
+            {
+                Line.remove_prefix(1);
+            }
+            if (Line.empty() || Line.front() == '#')
+            {
+                continue;
+            }
+            float Mach;
+            float Cd;
+            if (!ParseCsvKnot(Line, Mach, Cd))
+            {
+                if (!bHeaderAllowed)
+                {
+                    return DragCurveStatus::Malformed;
+                }
+                bHeaderAllowed = false;
+                continue;
+            }
+            bHeaderAllowed = false;
+            OutCurve.Mach.push_back(Mach);
+            OutCurve.Cd.push_back(Cd);
+        }
+        return OutCurve.Validate();
+    }
+
+    DragCurveStatus ParseDragCurveJson(std::string_view Json, DragCurve& OutCurve)
+    {
+        OutCurve.Mach.clear();
+        OutCurve.Cd.clear();
+        JsonReader Reader(Json);
+        if (!Reader.Consume('{'))
+        {
+            return DragCurveStatus::Malformed;
+        }
+        if (!Reader.Consume('}'))
+        {
+            do
+            {
+                std::string_view Key;
+                bool bEscaped;
+                if (!Reader.ReadString(Key, bEscaped) || !Reader.Consume(':'))
+                {
+                    return DragCurveStatus::Malformed;
+                }
+                const bool bParsed = Key == "mach" ? ParseJsonNumberArray(Reader, OutCurve.Mach)
+                    : Key == "cd" ? ParseJsonNumberArray(Reader, OutCurve.Cd)
+                    : Reader.SkipValue();
+                if (!bParsed)
+                {
+                    return DragCurveStatus::Malformed;
+                }
+            } while (Reader.Consume(','));
+            if (!Reader.Consume('}'))
+            {
+                return DragCurveStatus::Malformed;
+            }
+        }
+        if (Reader.Peek() != '\0')
+        {
+            return DragCurveStatus::Malformed;
+        }
+        return OutCurve.Validate();
+    }
+
+    DragCurveStatus LoadDragCurve(const std::filesystem::path& Path, DragCurve& OutCurve)
+    {
+        const MappedFile File(Path);
+        if (!File.IsOpen())
+        {
+            return DragCurveStatus::CantOpen;
+        }
+        return Path.extension() == ".json" ? ParseDragCurveJson(File.GetView(), OutCurve) : ParseDragCurveCsv(File.GetView(), OutCurve);
+    }
+}
@@ -0,0 +1,351 @@
+#include "DragKernel.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define BALLISTICS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only emit instructions beyond the target baseline in functions marked for them, MSVC always can
+#if defined(BALLISTICS_X86) && defined(__GNUC__)
+#define BALLISTICS_TARGET(Isa) __attribute__((target(Isa)))
+#else
+#define BALLISTICS_TARGET(Isa)
+#endif
+
+namespace Ballistics
+{
+    namespace
+    {
+        // as in GetSpeedOfSound
+        constexpr float GammaR = 1.4f * 287.05f;
+
+        // the lanes' Mach numbers, given or converted from speed and temperature
+        struct MachSource
+        {
+            const float* Mach = nullptr;
+            const float* Speed = nullptr;
+            const float* TemperatureK = nullptr;
+
+            float Get(size_t Index) const
+            {
+                return Mach ? Mach[Index] : Speed[Index] / std::sqrt(GammaR * TemperatureK[Index]);
+            }
+        };
+
+        // max(Floor, Base + (Mach - Knot) * Slope), each DragExtrapolation on one side of the table
+        struct Extrapolant
+        {
+            float Knot = 0.0f;
+            float Base = 0.0f;
+            float Slope = 0.0f;
+            float Floor = -std::numeric_limits<float>::infinity();
+        };
+
+        // the table's arrays and constants as the kernels read them
+        struct KernelTable
+        {
+            explicit KernelTable(const CompiledDragTable& InTable)
+                : Table(InTable), Mach(InTable.Mach.data()), Cd(InTable.Cd.data()), Slope(InTable.Slope.data()), Cubic(InTable.Cubic.data()),
+                GridSegment(reinterpret_cast<const int32_t*>(InTable.GridSegment.data())), Front(InTable.Mach.front()), Back(InTable.Mach.back()),
+                InvStep(InTable.GridInvStep), MaxCell(static_cast<int32_t>(InTable.GridSegment.size() - 1)), UniformStep(InTable.UniformStep),
+                InvUniformStep(InTable.UniformStep > 0.0f ? 1.0f / InTable.UniformStep : 0.0f), MaxSegment(static_cast<int32_t>(InTable.Slope.size() - 1)),
+                bCubic(InTable.Interpolation == DragInterpolation::MonotoneCubic), NaNCd(InTable.GetAtMach(std::numeric_limits<float>::quiet_NaN()))
+            {
+                switch (InTable.Extrapolation)
+                {
+                case DragExtrapolation::Clamp:
+                    Above = {Back, InTable.Cd.back()};
+                    Below = {Front, InTable.Cd.front()};
+                    break;
+                case DragExtrapolation::Linear:
+                    Above = {Back, InTable.Cd.back(), InTable.Slope.back(), 0.0f};
+                    Below = {Front, InTable.Cd.front(), InTable.Slope.front(), 0.0f};
+                    break;
+                default:
+                    Above = {Back};
+                    Below = Front > 0.0f ? Extrapolant{0.0f, 0.0f, InTable.Cd.front() / Front} : Extrapolant{Front, InTable.Cd.front()};
+                    break;
+                }
+            }
+
+            const CompiledDragTable& Table;
+            const float* Mach;
+            const float* Cd;
+            const float* Slope;
+            const float* Cubic;
+            const int32_t* GridSegment;
+            float Front;
+            float Back;
+            float InvStep;
+            int32_t MaxCell;
+            // knot n at Front + n*UniformStep, if positive
+            float UniformStep;
+            float InvUniformStep;
+            int32_t MaxSegment;
+            bool bCubic;
+            // what GetAtMach returns for NaN, which depends on the extrapolation
+            float NaNCd;
+            Extrapolant Above;
+            Extrapolant Below;
+        };
+
+        void DragScalar(const KernelTable& Kernel, const MachSource& Source, float* OutCd, size_t Begin, size_t End)
+        {
+            for (size_t n = Begin; n < End; ++n)
+            {
+                OutCd[n] = Kernel.Table.GetAtMach(Source.Get(n));
+            }
+        }
+
+#ifdef BALLISTICS_X86
+        BALLISTICS_TARGET("avx2")
+        __m256 Extrapolate8(const Extrapolant& Side, __m256 Mach)
+        {
+            const __m256 Value = _mm256_add_ps(_mm256_set1_ps(Side.Base), _mm256_mul_ps(_mm256_sub_ps(Mach, _mm256_set1_ps(Side.Knot)), _mm256_set1_ps(Side.Slope)));
+            return _mm256_max_ps(_mm256_set1_ps(Side.Floor), Value);
+        }
+
+        BALLISTICS_TARGET("avx2")
+        void DragAvx2(const KernelTable& Kernel, const MachSource& Source, float* OutCd, size_t Count)
+        {
+            const __m256 Front = _mm256_set1_ps(Kernel.Front);
+            const __m256 Back = _mm256_set1_ps(Kernel.Back);
+            const __m256 InvStep = _mm256_set1_ps(Kernel.InvStep);
+            const __m256 UniformStep = _mm256_set1_ps(Kernel.UniformStep);
+            const __m256 InvUniformStep = _mm256_set1_ps(Kernel.InvUniformStep);
+            const __m256 SpeedOfSoundScale = _mm256_set1_ps(GammaR);
+            const __m256i MaxCell = _mm256_set1_epi32(Kernel.MaxCell);
+            const __m256i MaxSegment = _mm256_set1_epi32(Kernel.MaxSegment);
+            const __m256i Zero = _mm256_setzero_si256();
+            const __m256 NaNCd = _mm256_set1_ps(Kernel.NaNCd);
+
+            size_t n = 0;
+            for (; n + 8 <= Count; n += 8)
+            {
+                const __m256 Mach = Source.Mach ? _mm256_loadu_ps(Source.Mach + n)
+                    : _mm256_div_ps(_mm256_loadu_ps(Source.Speed + n), _mm256_sqrt_ps(_mm256_mul_ps(SpeedOfSoundScale, _mm256_loadu_ps(Source.TemperatureK + n))));
+                const __m256 Inside = _mm256_min_ps(_mm256_max_ps(Mach, Front), Back);
+                __m256i Segment;
+                __m256 Lower;
+                if (Kernel.UniformStep > 0.0f)
+                {
+                    // the knots are computed rather than gathered, a lane within rounding of a knot may take the
+                    // neighbouring segment, which is continuous with its own there
+                    Segment = _mm256_min_epi32(_mm256_cvttps_epi32(_mm256_mul_ps(_mm256_sub_ps(Inside, Front), InvUniformStep)), MaxSegment);
+                    Lower = _mm256_add_ps(Front, _mm256_mul_ps(_mm256_cvtepi32_ps(Segment), UniformStep));
+                }
+                else
+                {
+                    const __m256i Cell = _mm256_min_epi32(_mm256_cvttps_epi32(_mm256_mul_ps(_mm256_sub_ps(Inside, Front), InvStep)), MaxCell);
+                    Segment = _mm256_i32gather_epi32(Kernel.GridSegment, Cell, 4);
+
+                    // the cell's segment is at most one knot off, either way; subtracting the all ones mask adds 1
+                    const __m256 UpperGuess = _mm256_i32gather_ps(Kernel.Mach + 1, Segment, 4);
+                    Segment = _mm256_sub_epi32(Segment, _mm256_castps_si256(_mm256_cmp_ps(Inside, UpperGuess, _CMP_GT_OQ)));
+                    const __m256 LowerGuess = _mm256_i32gather_ps(Kernel.Mach, Segment, 4);
+                    Segment = _mm256_add_epi32(Segment, _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(Inside, LowerGuess, _CMP_LT_OQ)), _mm256_cmpgt_epi32(Segment, Zero)));
+
+                    Lower = _mm256_i32gather_ps(Kernel.Mach, Segment, 4);
+                    const __m256 Upper = _mm256_i32gather_ps(Kernel.Mach + 1, Segment, 4);
+                    const __m256 Miss = _mm256_or_ps(_mm256_cmp_ps(Inside, Upper, _CMP_GT_OQ),
+                        _mm256_and_ps(_mm256_cmp_ps(Inside, Lower, _CMP_LT_OQ), _mm256_castsi256_ps(_mm256_cmpgt_epi32(Segment, Zero))));
+                    if (!_mm256_testz_ps(Miss, Miss))
+                    {
+                        DragScalar(Kernel, Source, OutCd, n, n + 8);
+                        continue;
+                    }
+                }
+
+                const __m256 Delta = _mm256_sub_ps(Inside, Lower);
+                const __m256 Cd = _mm256_i32gather_ps(Kernel.Cd, Segment, 4);
+                __m256 Result;
+                if (Kernel.bCubic)
+                {
+                    const __m256i Index = _mm256_add_epi32(Segment, _mm256_add_epi32(Segment, Segment));
+                    const __m256 C0 = _mm256_i32gather_ps(Kernel.Cubic, Index, 4);
+                    const __m256 C1 = _mm256_i32gather_ps(Kernel.Cubic + 1, Index, 4);
+                    const __m256 C2 = _mm256_i32gather_ps(Kernel.Cubic + 2, Index, 4);
+                    Result = _mm256_add_ps(Cd, _mm256_mul_ps(Delta, _mm256_add_ps(C0, _mm256_mul_ps(Delta, _mm256_add_ps(C1, _mm256_mul_ps(Delta, C2))))));
+                }
+                else
+                {
+                    Result = _mm256_add_ps(Cd, _mm256_mul_ps(Delta, _mm256_i32gather_ps(Kernel.Slope, Segment, 4)));
+                }
+                Result = _mm256_blendv_ps(Result, Extrapolate8(Kernel.Above, Mach), _mm256_cmp_ps(Mach, Back, _CMP_GT_OQ));
+                Result = _mm256_blendv_ps(Result, Extrapolate8(Kernel.Below, Mach), _mm256_cmp_ps(Mach, Front, _CMP_LT_OQ));
+                // NaN lanes fail both ordered compares above and were clamped to a knot
+                Result = _mm256_blendv_ps(Result, NaNCd, _mm256_cmp_ps(Mach, Mach, _CMP_UNORD_Q));
+                _mm256_storeu_ps(OutCd + n, Result);
+            }
+            DragScalar(Kernel, Source, OutCd, n, Count);
+        }
+
+        // SSE has no gathers, the indices go through memory
+        BALLISTICS_TARGET("sse4.1")
+        __m128 Gather4(const float* Base, __m128i Index)
+        {
+            alignas(16) int32_t Indices[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(Indices), Index);
+            return _mm_setr_ps(Base[Indices[0]], Base[Indices[1]], Base[Indices[2]], Base[Indices[3]]);
+        }
+
+        BALLISTICS_TARGET("sse4.1")
+        __m128i Gather4(const int32_t* Base, __m128i Index)
+        {
+            alignas(16) int32_t Indices[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(Indices), Index);
+            return _mm_setr_epi32(Base[Indices[0]], Base[Indices[1]], Base[Indices[2]], Base[Indices[3]]);
+        }
+
+        BALLISTICS_TARGET("sse4.1")
+        __m128 Extrapolate4(const Extrapolant& Side, __m128 Mach)
+        {
+            const __m128 Value = _mm_add_ps(_mm_set1_ps(Side.Base), _mm_mul_ps(_mm_sub_ps(Mach, _mm_set1_ps(Side.Knot)), _mm_set1_ps(Side.Slope)));
+            return _mm_max_ps(_mm_set1_ps(Side.Floor), Value);
+        }
+
+        BALLISTICS_TARGET("sse4.1")
+        void DragSse41(const KernelTable& Kernel, const MachSource& Source, float* OutCd, size_t Count)
+        {
+            const __m128 Front = _mm_set1_ps(Kernel.Front);
+            const __m128 Back = _mm_set1_ps(Kernel.Back);
+            const __m128 InvStep = _mm_set1_ps(Kernel.InvStep);
+            const __m128 UniformStep = _mm_set1_ps(Kernel.UniformStep);
+            const __m128 InvUniformStep = _mm_set1_ps(Kernel.InvUniformStep);
+            const __m128 SpeedOfSoundScale = _mm_set1_ps(GammaR);
+            const __m128i MaxCell = _mm_set1_epi32(Kernel.MaxCell);
+            const __m128i MaxSegment = _mm_set1_epi32(Kernel.MaxSegment);
+            const __m128i Zero = _mm_setzero_si128();
+            const __m128 NaNCd = _mm_set1_ps(Kernel.NaNCd);
+
+            size_t n = 0;
+            for (; n + 4 <= Count; n += 4)
+            {
+                const __m128 Mach = Source.Mach ? _mm_loadu_ps(Source.Mach + n)
+                    : _mm_div_ps(_mm_loadu_ps(Source.Speed + n), _mm_sqrt_ps(_mm_mul_ps(SpeedOfSoundScale, _mm_loadu_ps(Source.TemperatureK + n))));
+                const __m128 Inside = _mm_min_ps(_mm_max_ps(Mach, Front), Back);
+                __m128i Segment;
+                __m128 Lower;
+                if (Kernel.UniformStep > 0.0f)
+                {
+                    Segment = _mm_min_epi32(_mm_cvttps_epi32(_mm_mul_ps(_mm_sub_ps(Inside, Front), InvUniformStep)), MaxSegment);
+                    Lower = _mm_add_ps(Front, _mm_mul_ps(_mm_cvtepi32_ps(Segment), UniformStep));
+                }
+                else
+                {
+                    const __m128i Cell = _mm_min_epi32(_mm_cvttps_epi32(_mm_mul_ps(_mm_sub_ps(Inside, Front), InvStep)), MaxCell);
+                    Segment = Gather4(Kernel.GridSegment, Cell);
+
+                    const __m128 UpperGuess = Gather4(Kernel.Mach + 1, Segment);
+                    Segment = _mm_sub_epi32(Segment, _mm_castps_si128(_mm_cmpgt_ps(Inside, UpperGuess)));
+                    const __m128 LowerGuess = Gather4(Kernel.Mach, Segment);
+                    Segment = _mm_add_epi32(Segment, _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(Inside, LowerGuess)), _mm_cmpgt_epi32(Segment, Zero)));
+
+                    Lower = Gather4(Kernel.Mach, Segment);
+                    const __m128 Upper = Gather4(Kernel.Mach + 1, Segment);
+                    const __m128i Miss = _mm_castps_si128(_mm_or_ps(_mm_cmpgt_ps(Inside, Upper),
+                        _mm_and_ps(_mm_cmplt_ps(Inside, Lower), _mm_castsi128_ps(_mm_cmpgt_epi32(Segment, Zero)))));
+                    if (!_mm_testz_si128(Miss, Miss))
+                    {
+                        DragScalar(Kernel, Source, OutCd, n, n + 4);
+                        continue;
+                    }
+                }
+
+                const __m128 Delta = _mm_sub_ps(Inside, Lower);
+                const __m128 Cd = Gather4(Kernel.Cd, Segment);
+                __m128 Result;
+                if (Kernel.bCubic)
+                {
+                    const __m128i Index = _mm_add_epi32(Segment, _mm_add_epi32(Segment, Segment));
+                    const __m128 C0 = Gather4(Kernel.Cubic, Index);
+                    const __m128 C1 = Gather4(Kernel.Cubic + 1, Index);
+                    const __m128 C2 = Gather4(Kernel.Cubic + 2, Index);
+                    Result = _mm_add_ps(Cd, _mm_mul_ps(Delta, _mm_add_ps(C0, _mm_mul_ps(Delta, _mm_add_ps(C1, _mm_mul_ps(Delta, C2))))));
+                }
+                else
+                {
+                    Result = _mm_add_ps(Cd, _mm_mul_ps(Delta, Gather4(Kernel.Slope, Segment)));
+                }
+                Result = _mm_blendv_ps(Result, Extrapolate4(Kernel.Above, Mach), _mm_cmpgt_ps(Mach, Back));
+                Result = _mm_blendv_ps(Result, Extrapolate4(Kernel.Below, Mach), _mm_cmplt_ps(Mach, Front));
+                Result = _mm_blendv_ps(Result, NaNCd, _mm_cmpunord_ps(Mach, Mach));
+                _mm_storeu_ps(OutCd + n, Result);
+            }
+            DragScalar(Kernel, Source, OutCd, n, Count);
+        }
+#endif
+
+        SimdLevel DetectSimdLevel()
+        {
+#if defined(BALLISTICS_X86) && defined(_MSC_VER)
+            int Info[4];
+            __cpuid(Info, 0);
+            const int MaxLeaf = Info[0];
+            __cpuid(Info, 1);
+            const bool bSse41 = (Info[2] & (1 << 19)) != 0;
+            // AVX registers also need saving by the OS
+            const bool bOsAvx = (Info[2] & (1 << 27)) != 0 && (Info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+            bool bAvx2 = false;
+            if (MaxLeaf >= 7 && bOsAvx)
+            {
+                __cpuidex(Info, 7, 0);
+                bAvx2 = (Info[1] & (1 << 5)) != 0;
+            }
+            return bAvx2 ? SimdLevel::AVX2 : bSse41 ? SimdLevel::SSE41 : SimdLevel::Scalar;
+#elif defined(BALLISTICS_X86)
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? SimdLevel::AVX2 : __builtin_cpu_supports("sse4.1") ? SimdLevel::SSE41 : SimdLevel::Scalar;
+#else
+            return SimdLevel::Scalar;
+#endif
+        }
+
+        void Dispatch(const CompiledDragTable& Table, const MachSource& Source, float* OutCd, size_t Count, SimdLevel Level)
+        {
+            const KernelTable Kernel(Table);
+            switch (std::min(Level, GetSupportedSimdLevel()))
+            {
+#ifdef BALLISTICS_X86
+            case SimdLevel::AVX2:
+                DragAvx2(Kernel, Source, OutCd, Count);
+                break;
+            case SimdLevel::SSE41:
+                DragSse41(Kernel, Source, OutCd, Count);
+                break;
+#endif
+            default:
+                DragScalar(Kernel, Source, OutCd, 0, Count);
+                break;
+            }
+        }
+    }
+
+    SimdLevel GetSupportedSimdLevel()
+    {
+        static const SimdLevel Level = DetectSimdLevel();
+        return Level;
+    }
+
+    void GetDragCoefficientsAtMach(const CompiledDragTable& Table, std::span<const float> Mach, std::span<float> OutCd, SimdLevel Level)
+    {
+        assert(OutCd.size() == Mach.size() && !Table.IsEmpty());
+        Dispatch(Table, MachSource{.Mach = Mach.data()}, OutCd.data(), std::min(Mach.size(), OutCd.size()), Level);
+    }
+
+    void GetDragCoefficients(const CompiledDragTable& Table, std::span<const float> Speed, std::span<const float> TemperatureK, std::span<float> OutCd, SimdLevel Level)
+    {
+        assert(OutCd.size() == Speed.size() && TemperatureK.size() == Speed.size() && !Table.IsEmpty());
+        Dispatch(Table, MachSource{.Speed = Speed.data(), .TemperatureK = TemperatureK.data()}, OutCd.data(),
+            std::min({Speed.size(), TemperatureK.size(), OutCd.size()}), Level);
+    }
+}
@@ -0,0 +1,147 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Ballistics
+{
+    MappedFile::MappedFile(MappedFile&& Other) noexcept
+    {
+        Swap(Other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& Other) noexcept
+    {
+        if (this != &Other)
+        {
+            Close();
+            Swap(Other);
+        }
+        return *this;
+    }
+
+    void MappedFile::Swap(MappedFile& Other) noexcept
+    {
+#ifdef _WIN32
+        std::swap(FileHandle, Other.FileHandle);
+        std::swap(MappingHandle, Other.MappingHandle);
+#else
+        std::swap(FileDescriptor, Other.FileDescriptor);
+#endif
+        std::swap(Data, Other.Data);
+        std::swap(Size, Other.Size);
+        std::swap(bOpen, Other.bOpen);
+    }
+
+#ifdef _WIN32
+    bool MappedFile::Open(const std::filesystem::path& Path)
+    {
+        Close();
+        FileHandle = CreateFileW(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (FileHandle == INVALID_HANDLE_VALUE)
+        {
+            FileHandle = nullptr;
+            return false;
+        }
+        LARGE_INTEGER FileSize;
+        if (!GetFileSizeEx(FileHandle, &FileSize))
+        {
+            Close();
+            return false;
+        }
+        Size = static_cast<size_t>(FileSize.QuadPart);
+        bOpen = true;
+        // an empty file can't be mapped
+        if (Size == 0)
+        {
+            return true;
+        }
+        MappingHandle = CreateFileMappingW(FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        Data = MappingHandle ? MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!Data)
+        {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (Data)
+        {
+            UnmapViewOfFile(Data);
+        }
+        if (MappingHandle)
+        {
+            CloseHandle(MappingHandle);
+        }
+        if (FileHandle)
+        {
+            CloseHandle(FileHandle);
+        }
+        FileHandle = MappingHandle = nullptr;
+        Data = nullptr;
+        Size = 0;
+        bOpen = false;
+    }
+#else
+    bool MappedFile::Open(const std::filesystem::path& Path)
+    {
+        Close();
+        FileDescriptor = open(Path.c_str(), O_RDONLY);
+        if (FileDescriptor < 0)
+        {
+            return false;
+        }
+        struct stat FileStat;
+        if (fstat(FileDescriptor, &FileStat) != 0)
+        {
+            Close();
+            return false;
+        }
+        Size = static_cast<size_t>(FileStat.st_size);
+        bOpen = true;
+        // an empty file can't be mapped
+        if (Size == 0)
+        {
+            return true;
+        }
+        void* Mapping = mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, FileDescriptor, 0);
+        if (Mapping == MAP_FAILED)
+        {
+            Close();
+            return false;
+        }
+        madvise(Mapping, Size, MADV_SEQUENTIAL);
+        Data = Mapping;
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (Data)
+        {
+            munmap(const_cast<void*>(Data), Size);
+        }
+        if (FileDescriptor >= 0)
+        {
+            close(FileDescriptor);
+        }
+        FileDescriptor = -1;
+        Data = nullptr;
+        Size = 0;
+        bOpen = false;
+    }
+#endif
+}
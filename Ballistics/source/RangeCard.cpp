@@ -0,0 +1,68 @@
+#include "RangeCard.h"
+
+#include <cmath>
+#include <limits>
+
+namespace Ballistics
+{
+    void GenerateRangeCard(std::span<RangeCardRow> OutRows, const RangeCardLoad& InLoad, const EnvironmentData& Environment, const RangeCardParams& Params)
+    {
+        if (OutRows.empty())
+        {
+            return;
+        }
+
+        for (size_t nRow = 0; nRow < OutRows.size(); ++nRow)
+        {
+            OutRows[nRow] = RangeCardRow{};
+            OutRows[nRow].Distance = Params.DistanceStep * static_cast<float>(nRow + 1);
+        }
+
+        FiringData Firing = InLoad.Firing;
+        // rows from the last trial angle of a zeroing that didn't converge would look valid but be off the zero
+        if (Firing.ZeroDistance > 0.0f && !Firing.ZeroIn(*InLoad.DragTable, Params.ZeroToleranceM, Environment).bConverged)
+        {
+            return;
+        }
+
+        SolverParams Solver;
+        Solver.TimeStep = Params.TimeStep;
+        Solver.MaxTime = Params.MaxTime;
+        Solver.Integrator = Params.Integrator;
+        Solver.bCoriolis = Params.bCoriolis;
+        Solver.MaxX = Params.DistanceStep * static_cast<float>(OutRows.size() + 1);
+        // a range card is relative to the line of sight, don't stop at the ground
+        Solver.MinY = std::numeric_limits<float>::lowest();
+
+        // rows are sampled at every DistanceStep as the trajectory is integrated
+        Solver.OutputDistanceStep = Params.DistanceStep;
+
+        const float MassKg = Firing.Bullet.GetMassKg();
+        size_t nRow = 0;
+        SolveTrajectory(*InLoad.DragTable, [&](const TrajectoryDataPoint& Q)
+            {
+                RangeCardRow& Row = OutRows[nRow++];
+                Row.DropM = Q.Position.GetY() - Firing.Height;
+                Row.DropMil = 1000.0f * std::atan2(Row.DropM, Row.Distance);
+                Row.DriftM = Q.Drift;
+                const float SpeedSq = Q.Velocity.LengthSq() + Q.DriftVelocity * Q.DriftVelocity;
+                Row.VelocityMs = std::sqrt(SpeedSq);
+                Row.EnergyJ = 0.5f * MassKg * SpeedSq;
+                Row.TimeOfFlightS = Q.T;
+                Row.bValid = true;
+                return nRow < OutRows.size();
+            }, Firing, Environment, Solver);
+    }
+
+    void GenerateRangeCards(WorkStealingPool& Pool, RangeCards& OutCards, std::span<const RangeCardLoad> InLoads, std::span<const EnvironmentData> InEnvironments, const RangeCardParams& Params)
+    {
+        OutCards.Resize(InLoads.size(), InEnvironments.size(), Params);
+        const size_t NumEnvironments = InEnvironments.size();
+        Pool.ParallelFor(InLoads.size() * NumEnvironments, [&](size_t TaskIndex)
+            {
+                const size_t LoadIndex = TaskIndex / NumEnvironments;
+                const size_t EnvironmentIndex = TaskIndex % NumEnvironments;
+                GenerateRangeCard(OutCards.GetCard(LoadIndex, EnvironmentIndex), InLoads[LoadIndex], InEnvironments[EnvironmentIndex], Params);
+            });
+    }
+}
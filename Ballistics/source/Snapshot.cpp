@@ -0,0 +1,500 @@
+#include "Snapshot.h"
+#include "DragCurve.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+namespace Ballistics
+{
+    namespace
+    {
+        constexpr char Magic[8] = {'B', 'A', 'L', 'S', 'N', 'A', 'P', '\0'};
+        // reads back differently on a machine of the other byte order
+        constexpr uint32_t ByteOrderMark = 0x01020304u;
+        constexpr uint64_t SectionAlignment = 64;
+        constexpr size_t MaxSectionName = 48;
+        constexpr size_t MaxDragTableName = 24;
+
+        enum class ElementType : uint32_t
+        {
+            Float32 = 1,
+            UInt32 = 2,
+            Char = 3,
+        };
+
+        struct FileHeader
+        {
+            char Magic[8];
+            uint32_t Version;
+            uint32_t ByteOrderMark;
+            uint64_t FileSize;
+            uint64_t NumSections;
+            // FNV-1a of the section directory
+            uint64_t DirectoryChecksum;
+        };
+        static_assert(sizeof(FileHeader) == 40);
+
+        struct SectionEntry
+        {
+            char Name[MaxSectionName];
+            ElementType Type;
+            uint32_t ElementSize;
+            // from the start of the file, a multiple of SectionAlignment
+            uint64_t Offset;
+            uint64_t Count;
+        };
+        static_assert(sizeof(SectionEntry) == 72);
+
+        template<typename T>
+        constexpr ElementType GetElementType()
+        {
+            if constexpr (std::is_same_v<T, float>)
+            {
+                return ElementType::Float32;
+            }
+            else if constexpr (std::is_same_v<T, uint32_t>)
+            {
+                return ElementType::UInt32;
+            }
+            else
+            {
+                static_assert(std::is_same_v<T, char>);
+                return ElementType::Char;
+            }
+        }
+
+        uint64_t AlignUp(uint64_t Value)
+        {
+            return (Value + SectionAlignment - 1) & ~(SectionAlignment - 1);
+        }
+
+        uint64_t Checksum(const void* Data, size_t Size)
+        {
+            uint64_t Hash = 14695981039346656037ull;
+            for (size_t n = 0; n < Size; ++n)
+            {
+                Hash = (Hash ^ static_cast<const uint8_t*>(Data)[n]) * 1099511628211ull;
+            }
+            return Hash;
+        }
+
+        uint64_t GetDirectoryOffset()
+        {
+            return AlignUp(sizeof(FileHeader));
+        }
+
+        class SectionWriter
+        {
+        public:
+            template<typename T>
+            void Add(const std::string& Name, std::span<const T> Elements)
+            {
+                Pending.push_back({Name, GetElementType<T>(), sizeof(T), Elements.data(), Elements.size()});
+            }
+
+            bool Write(const std::filesystem::path& Path) const
+            {
+                std::vector<SectionEntry> Directory(Pending.size());
+                uint64_t Offset = AlignUp(GetDirectoryOffset() + Directory.size() * sizeof(SectionEntry));
+                for (size_t n = 0; n < Pending.size(); ++n)
+                {
+                    SectionEntry& Entry = Directory[n];
+                    std::memset(&Entry, 0, sizeof(Entry));
+                    std::memcpy(Entry.Name, Pending[n].Name.data(), std::min(Pending[n].Name.size(), MaxSectionName - 1));
+                    Entry.Type = Pending[n].Type;
+                    Entry.ElementSize = Pending[n].ElementSize;
+                    Entry.Offset = Offset;
+                    Entry.Count = Pending[n].Count;
+                    Offset = AlignUp(Offset + Entry.Count * Entry.ElementSize);
+                }
+
+                FileHeader Header;
+                std::memcpy(Header.Magic, Magic, sizeof(Magic));
+                Header.Version = Snapshot::Version;
+                Header.ByteOrderMark = ByteOrderMark;
+                Header.FileSize = Offset;
+                Header.NumSections = Directory.size();
+                Header.DirectoryChecksum = Checksum(Directory.data(), Directory.size() * sizeof(SectionEntry));
+
+                std::ofstream Stream(Path, std::ios::binary | std::ios::trunc);
+                uint64_t Position = 0;
+                const auto WriteAt = [&Stream, &Position](uint64_t At, const void* Data, uint64_t Size)
+                    {
+                        static constexpr char Padding[SectionAlignment] = {};
+                        while (Position < At)
+                        {
+                            const uint64_t PaddingSize = std::min<uint64_t>(At - Position, SectionAlignment);
+                            Stream.write(Padding, static_cast<std::streamsize>(PaddingSize));
+                            Position += PaddingSize;
+                        }
+                        Stream.write(static_cast<const char*>(Data), static_cast<std::streamsize>(Size));
+                        Position += Size;
+                    };
+                WriteAt(0, &Header, sizeof(Header));
+                WriteAt(GetDirectoryOffset(), Directory.data(), Directory.size() * sizeof(SectionEntry));
+                for (size_t n = 0; n < Pending.size(); ++n)
+                {
+                    WriteAt(Directory[n].Offset, Pending[n].Data, Directory[n].Count * Directory[n].ElementSize);
+                }
+                WriteAt(Header.FileSize, nullptr, 0);
+                return Stream.good();
+            }
+
+        private:
+            struct PendingSection
+            {
+                std::string Name;
+                ElementType Type;
+                uint32_t ElementSize;
+                const void* Data;
+                uint64_t Count;
+            };
+            std::vector<PendingSection> Pending;
+        };
+
+        class SectionReader
+        {
+        public:
+            SnapshotStatus Open(const MappedFile& InFile)
+            {
+                File = &InFile;
+                FileHeader Header;
+                if (InFile.GetSize() < sizeof(Header))
+                {
+                    return SnapshotStatus::BadHeader;
+                }
+                std::memcpy(&Header, InFile.GetData(), sizeof(Header));
+                if (std::memcmp(Header.Magic, Magic, sizeof(Magic)) != 0 || Header.ByteOrderMark != ByteOrderMark)
+                {
+                    return SnapshotStatus::BadHeader;
+                }
+                if (Header.Version != Snapshot::Version)
+                {
+                    return SnapshotStatus::UnsupportedVersion;
+                }
+                const uint64_t DirectorySize = Header.NumSections * sizeof(SectionEntry);
+                if (Header.FileSize != InFile.GetSize() || Header.NumSections > InFile.GetSize() / sizeof(SectionEntry)
+                    || GetDirectoryOffset() + DirectorySize > InFile.GetSize())
+                {
+                    return SnapshotStatus::Corrupt;
+                }
+                Directory = {reinterpret_cast<const SectionEntry*>(InFile.GetData() + GetDirectoryOffset()), static_cast<size_t>(Header.NumSections)};
+                if (Checksum(Directory.data(), DirectorySize) != Header.DirectoryChecksum)
+                {
+                    return SnapshotStatus::Corrupt;
+                }
+                for (const SectionEntry& Entry : Directory)
+                {
+                    const bool bTerminated = std::memchr(Entry.Name, '\0', MaxSectionName) != nullptr;
+                    const bool bKnownType = (Entry.Type == ElementType::Float32 && Entry.ElementSize == 4)
+                        || (Entry.Type == ElementType::UInt32 && Entry.ElementSize == 4)
+                        || (Entry.Type == ElementType::Char && Entry.ElementSize == 1);
+                    const bool bInFile = Entry.Offset % SectionAlignment == 0 && Entry.Offset <= Header.FileSize
+                        && Entry.Count <= (Header.FileSize - Entry.Offset) / std::max<uint32_t>(Entry.ElementSize, 1);
+                    if (!bTerminated || !bKnownType || !bInFile)
+                    {
+                        return SnapshotStatus::Corrupt;
+                    }
+                }
+                // FindEntry returns the first of a repeated name, e.g. a custom drag table written as G1 would read back as G1
+                for (size_t n = 0; n < Directory.size(); ++n)
+                {
+                    for (size_t m = 0; m < n; ++m)
+                    {
+                        if (std::strcmp(Directory[n].Name, Directory[m].Name) == 0)
+                        {
+                            return SnapshotStatus::Corrupt;
+                        }
+                    }
+                }
+                return SnapshotStatus::Ok;
+            }
+
+            bool Contains(std::string_view Name) const
+            {
+                return FindEntry(Name) != nullptr;
+            }
+
+            // false if there's no section Name of elements T
+            template<typename T>
+            bool Find(std::string_view Name, FlatArray<T>& OutArray) const
+            {
+                const SectionEntry* Entry = FindEntry(Name);
+                if (!Entry || Entry->Type != GetElementType<T>())
+                {
+                    return false;
+                }
+                OutArray = FlatArray<T>::View({reinterpret_cast<const T*>(File->GetData() + Entry->Offset), static_cast<size_t>(Entry->Count)});
+                return true;
+            }
+
+            std::span<const SectionEntry> GetDirectory() const
+            {
+                return Directory;
+            }
+
+        private:
+            const SectionEntry* FindEntry(std::string_view Name) const
+            {
+                for (const SectionEntry& Entry : Directory)
+                {
+                    if (Name == Entry.Name)
+                    {
+                        return &Entry;
+                    }
+                }
+                return nullptr;
+            }
+
+            const MappedFile* File = nullptr;
+            std::span<const SectionEntry> Directory;
+        };
+    }
+
+    /**
+     * @brief Maps the private arrays of the catalogue and string pool to and from named sections.
+     */
+    class SnapshotSerializer
+    {
+    public:
+        static constexpr const char* IndexFieldNames[BulletCatalogue::NumIndexFields] = {"CallibreMm", "MassGr", "G1BC", "G7BC"};
+
+        static void Write(SectionWriter& Writer, const BulletCatalogue& Catalogue)
+        {
+            const auto Fields = Catalogue.FieldArrays();
+            for (size_t nField = 0; nField < BulletCatalogue::NumIndexFields; ++nField)
+            {
+                const std::string Field = IndexFieldNames[nField];
+                Writer.Add<float>("catalogue/" + Field, *Fields[nField]);
+                Writer.Add<uint32_t>("catalogue/index/" + Field + "/Order", Catalogue.Indices[nField].Order);
+                Writer.Add<float>("catalogue/index/" + Field + "/Keys", Catalogue.Indices[nField].Keys);
+            }
+            Writer.Add<uint32_t>("catalogue/CompanyId", Catalogue.CompanyId);
+            Writer.Add<uint32_t>("catalogue/NameId", Catalogue.NameId);
+            Writer.Add<uint32_t>("catalogue/DescriptionId", Catalogue.DescriptionId);
+            Writer.Add<char>("catalogue/strings/Chars", Catalogue.Strings.Chars);
+            Writer.Add<uint32_t>("catalogue/strings/Offsets", Catalogue.Strings.Offsets);
+            Writer.Add<uint32_t>("catalogue/strings/Buckets", Catalogue.Strings.Buckets);
+        }
+
+        static bool Read(const SectionReader& Reader, BulletCatalogue& OutCatalogue)
+        {
+            BulletCatalogue Catalogue;
+            if (!Reader.Contains("catalogue/MassGr"))
+            {
+                OutCatalogue = std::move(Catalogue);
+                return true;
+            }
+
+            FlatArray<float>* Fields[BulletCatalogue::NumIndexFields] = {&Catalogue.CallibreMm, &Catalogue.MassGr, &Catalogue.G1BC, &Catalogue.G7BC};
+            bool bValid = true;
+            for (size_t nField = 0; nField < BulletCatalogue::NumIndexFields; ++nField)
+            {
+                const std::string Field = IndexFieldNames[nField];
+                bValid &= Reader.Find("catalogue/" + Field, *Fields[nField]);
+                bValid &= Reader.Find("catalogue/index/" + Field + "/Order", Catalogue.Indices[nField].Order);
+                bValid &= Reader.Find("catalogue/index/" + Field + "/Keys", Catalogue.Indices[nField].Keys);
+            }
+            bValid &= Reader.Find("catalogue/CompanyId", Catalogue.CompanyId);
+            bValid &= Reader.Find("catalogue/NameId", Catalogue.NameId);
+            bValid &= Reader.Find("catalogue/DescriptionId", Catalogue.DescriptionId);
+            bValid &= Reader.Find("catalogue/strings/Chars", Catalogue.Strings.Chars);
+            bValid &= Reader.Find("catalogue/strings/Offsets", Catalogue.Strings.Offsets);
+            bValid &= Reader.Find("catalogue/strings/Buckets", Catalogue.Strings.Buckets);
+            if (!bValid)
+            {
+                return false;
+            }
+
+            // sizes only, checking the contents would page in the whole catalogue
+            const size_t NumBullets = Catalogue.Size();
+            for (size_t nField = 0; nField < BulletCatalogue::NumIndexFields; ++nField)
+            {
+                bValid &= Fields[nField]->size() == NumBullets;
+                bValid &= Catalogue.Indices[nField].Order.size() == NumBullets && Catalogue.Indices[nField].Keys.size() == NumBullets;
+            }
+            bValid &= Catalogue.CompanyId.size() == NumBullets && Catalogue.NameId.size() == NumBullets && Catalogue.DescriptionId.size() == NumBullets;
+            const StringPool& Strings = Catalogue.Strings;
+            bValid &= !Strings.Offsets.empty() && Strings.Offsets.back() == Strings.Chars.size();
+            bValid &= Strings.Buckets.empty() ? Strings.Size() == 0 : std::has_single_bit(Strings.Buckets.size()) && Strings.Buckets.size() > Strings.Size();
+            if (!bValid)
+            {
+                return false;
+            }
+            Catalogue.bIndexed = true;
+            OutCatalogue = std::move(Catalogue);
+            return true;
+        }
+
+        static void Write(SectionWriter& Writer, const std::string& Name, const CompiledDragTable& Table)
+        {
+            const std::string Prefix = "drag/" + Name + "/";
+            Writer.Add<float>(Prefix + "Mach", Table.Mach);
+            Writer.Add<float>(Prefix + "Cd", Table.Cd);
+            Writer.Add<float>(Prefix + "Slope", Table.Slope);
+            Writer.Add<uint32_t>(Prefix + "GridSegment", Table.GridSegment);
+            Writer.Add<float>(Prefix + "GridInvStep", std::span(&Table.GridInvStep, 1));
+            Writer.Add<float>(Prefix + "UniformStep", std::span(&Table.UniformStep, 1));
+            Writer.Add<uint32_t>(Prefix + "Extrapolation", std::span(reinterpret_cast<const uint32_t*>(&Table.Extrapolation), 1));
+            Writer.Add<uint32_t>(Prefix + "Interpolation", std::span(reinterpret_cast<const uint32_t*>(&Table.Interpolation), 1));
+            Writer.Add<float>(Prefix + "Cubic", Table.Cubic);
+        }
+
+        static bool Read(const SectionReader& Reader, const std::string& Name, CompiledDragTable& OutTable)
+        {
+            const std::string Prefix = "drag/" + Name + "/";
+            FlatArray<float> GridInvStep;
+            FlatArray<float> UniformStep;
+            FlatArray<uint32_t> Extrapolation;
+            FlatArray<uint32_t> Interpolation;
+            const bool bFound = Reader.Find(Prefix + "Mach", OutTable.Mach) && Reader.Find(Prefix + "Cd", OutTable.Cd)
+                && Reader.Find(Prefix + "Slope", OutTable.Slope) && Reader.Find(Prefix + "GridSegment", OutTable.GridSegment)
+                && Reader.Find(Prefix + "GridInvStep", GridInvStep) && Reader.Find(Prefix + "UniformStep", UniformStep)
+                && Reader.Find(Prefix + "Extrapolation", Extrapolation)
+                && Reader.Find(Prefix + "Interpolation", Interpolation) && Reader.Find(Prefix + "Cubic", OutTable.Cubic);
+            if (!bFound || GridInvStep.size() != 1 || UniformStep.size() != 1 || OutTable.IsEmpty() || OutTable.Cd.size() != OutTable.Mach.size()
+                || OutTable.Slope.size() + 1 != OutTable.Mach.size() || OutTable.GridSegment.empty()
+                || Extrapolation.size() != 1 || Extrapolation[0] > static_cast<uint32_t>(DragExtrapolation::Linear)
+                || Interpolation.size() != 1 || Interpolation[0] > static_cast<uint32_t>(DragInterpolation::MonotoneCubic))
+            {
+                return false;
+            }
+            OutTable.GridInvStep = GridInvStep[0];
+            OutTable.UniformStep = UniformStep[0];
+            OutTable.Extrapolation = static_cast<DragExtrapolation>(Extrapolation[0]);
+            OutTable.Interpolation = static_cast<DragInterpolation>(Interpolation[0]);
+            if (OutTable.Interpolation == DragInterpolation::MonotoneCubic && OutTable.Cubic.size() != 3 * OutTable.Slope.size())
+            {
+                return false;
+            }
+
+            // unlike the catalogue the tables are small, and the lookups index by them unchecked: the knots, the grid
+            // and the steps must be exactly as Compile leaves them
+            if (ValidateDragCurve(OutTable.Mach, OutTable.Cd) != DragCurveStatus::Ok)
+            {
+                return false;
+            }
+            const size_t NumSegments = OutTable.Slope.size();
+            const float MachRange = OutTable.Mach.back() - OutTable.Mach.front();
+            if (OutTable.GridInvStep != static_cast<float>(OutTable.GridSegment.size() - 1) / MachRange
+                || (OutTable.UniformStep != 0.0f && OutTable.UniformStep != MachRange / static_cast<float>(NumSegments)))
+            {
+                return false;
+            }
+            if (!std::all_of(OutTable.GridSegment.begin(), OutTable.GridSegment.end(), [NumSegments](uint32_t Segment)
+                {
+                    return Segment < NumSegments;
+                }))
+            {
+                return false;
+            }
+            OutTable.ContentHash = HashDragTable(OutTable);
+            return true;
+        }
+    };
+
+    SnapshotStatus Snapshot::Open(const std::filesystem::path& Path)
+    {
+        Close();
+        if (!File.Open(Path))
+        {
+            return SnapshotStatus::CantOpen;
+        }
+
+        SectionReader Reader;
+        SnapshotStatus Status = Reader.Open(File);
+        if (Status == SnapshotStatus::Ok && !SnapshotSerializer::Read(Reader, Catalogue))
+        {
+            Status = SnapshotStatus::Corrupt;
+        }
+        // drag tables are found by their first section
+        constexpr std::string_view DragPrefix = "drag/";
+        constexpr std::string_view DragSuffix = "/Mach";
+        for (const SectionEntry& Entry : Reader.GetDirectory())
+        {
+            const std::string_view SectionName(Entry.Name);
+            if (Status != SnapshotStatus::Ok || !SectionName.starts_with(DragPrefix) || !SectionName.ends_with(DragSuffix))
+            {
+                continue;
+            }
+            std::string Name(SectionName.substr(DragPrefix.size(), SectionName.size() - DragPrefix.size() - DragSuffix.size()));
+            CompiledDragTable Table;
+            if (!SnapshotSerializer::Read(Reader, Name, Table))
+            {
+                Status = SnapshotStatus::Corrupt;
+                break;
+            }
+            DragTables.emplace_back(std::move(Name), std::move(Table));
+        }
+
+        if (Status != SnapshotStatus::Ok)
+        {
+            Close();
+        }
+        return Status;
+    }
+
+    void Snapshot::Close()
+    {
+        Catalogue.Clear();
+        DragTables.clear();
+        File.Close();
+    }
+
+    const CompiledDragTable* Snapshot::FindDragTable(std::string_view Name) const
+    {
+        for (const auto& [TableName, Table] : DragTables)
+        {
+            if (TableName == Name)
+            {
+                return &Table;
+            }
+        }
+        return nullptr;
+    }
+
+    std::vector<std::string_view> Snapshot::GetDragTableNames() const
+    {
+        std::vector<std::string_view> Names;
+        for (const auto& [TableName, Table] : DragTables)
+        {
+            Names.push_back(TableName);
+        }
+        return Names;
+    }
+
+    bool WriteSnapshot(const std::filesystem::path& Path, const BulletCatalogue& Catalogue, std::span<const SnapshotDragTable> DragTables)
+    {
+        SectionWriter Writer;
+        BulletCatalogue IndexedCatalogue;
+        if (Catalogue.Size() > 0)
+        {
+            const BulletCatalogue* Source = &Catalogue;
+            if (!Catalogue.IsIndexed())
+            {
+                IndexedCatalogue = Catalogue;
+                IndexedCatalogue.BuildIndices();
+                Source = &IndexedCatalogue;
+            }
+            SnapshotSerializer::Write(Writer, *Source);
+        }
+        for (size_t n = 0; n < DragTables.size(); ++n)
+        {
+            const SnapshotDragTable& DragTable = DragTables[n];
+            const auto SameName = [&DragTable](const SnapshotDragTable& Other)
+                {
+                    return Other.Name == DragTable.Name;
+                };
+            if (DragTable.Name.empty() || DragTable.Name.size() > MaxDragTableName || !DragTable.Table || DragTable.Table->IsEmpty()
+                || std::any_of(DragTables.begin(), DragTables.begin() + n, SameName))
+            {
+                return false;
+            }
+            SnapshotSerializer::Write(Writer, std::string(DragTable.Name), *DragTable.Table);
+        }
+        return Writer.Write(Path);
+    }
+}
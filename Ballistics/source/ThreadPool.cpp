@@ -0,0 +1,149 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Ballistics
+{
+    namespace
+    {
+        // the pool whose tasks this thread is running, a worker's own or the one a ParallelFor caller works for
+        thread_local const WorkStealingPool* RunningPool = nullptr;
+    }
+
+    WorkStealingPool::WorkStealingPool(size_t NumThreads)
+    {
+        if (NumThreads == 0)
+        {
+            NumThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+
+        Queues.reserve(NumThreads);
+        for (size_t n = 0; n < NumThreads; ++n)
+        {
+            Queues.push_back(std::make_unique<WorkQueue>());
+        }
+        // queue 0 belongs to the thread calling ParallelFor
+        Workers.reserve(NumThreads - 1);
+        for (size_t n = 1; n < NumThreads; ++n)
+        {
+            Workers.emplace_back(&WorkStealingPool::WorkerLoop, this, n);
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool()
+    {
+        {
+            std::lock_guard Lock(Mutex);
+            bStopping = true;
+        }
+        WakeCondition.notify_all();
+        for (std::thread& Worker : Workers)
+        {
+            Worker.join();
+        }
+    }
+
+    void WorkStealingPool::ParallelFor(size_t NumTasks, const TaskType& Task)
+    {
+        if (NumTasks == 0)
+        {
+            return;
+        }
+        assert(RunningPool != this && "ParallelFor called from a task of the same pool");
+
+        std::lock_guard CallLock(CallMutex);
+        const WorkStealingPool* const OuterPool = RunningPool;
+        RunningPool = this;
+        {
+            std::lock_guard Lock(Mutex);
+            CurrentTask = &Task;
+            RemainingTasks = NumTasks;
+            const size_t NumQueues = Queues.size();
+            for (size_t nQueue = 0; nQueue < NumQueues; ++nQueue)
+            {
+                WorkQueue& Queue = *Queues[nQueue];
+                std::lock_guard QueueLock(Queue.Mutex);
+                for (size_t nTask = nQueue * NumTasks / NumQueues; nTask < (nQueue + 1) * NumTasks / NumQueues; ++nTask)
+                {
+                    Queue.Tasks.push_back(nTask);
+                }
+            }
+            ++Generation;
+        }
+        WakeCondition.notify_all();
+
+        while (RunOne(0))
+        {
+        }
+
+        std::unique_lock Lock(Mutex);
+        DoneCondition.wait(Lock, [this]() { return RemainingTasks == 0; });
+        CurrentTask = nullptr;
+        RunningPool = OuterPool;
+    }
+
+    void WorkStealingPool::WorkerLoop(size_t WorkerIndex)
+    {
+        RunningPool = this;
+        uint64_t LastGeneration = 0;
+        for (;;)
+        {
+            {
+                std::unique_lock Lock(Mutex);
+                WakeCondition.wait(Lock, [this, LastGeneration]() { return bStopping || Generation != LastGeneration; });
+                if (bStopping)
+                {
+                    return;
+                }
+                LastGeneration = Generation;
+            }
+
+            while (RunOne(WorkerIndex))
+            {
+            }
+        }
+    }
+
+    bool WorkStealingPool::RunOne(size_t WorkerIndex)
+    {
+        size_t TaskIndex = 0;
+        bool bFound = false;
+        {
+            WorkQueue& Own = *Queues[WorkerIndex];
+            std::lock_guard Lock(Own.Mutex);
+            if (!Own.Tasks.empty())
+            {
+                TaskIndex = Own.Tasks.back();
+                Own.Tasks.pop_back();
+                bFound = true;
+            }
+        }
+
+        // steal from the other end of someone else's queue
+        for (size_t nOffset = 1; !bFound && nOffset < Queues.size(); ++nOffset)
+        {
+            WorkQueue& Victim = *Queues[(WorkerIndex + nOffset) % Queues.size()];
+            std::lock_guard Lock(Victim.Mutex);
+            if (!Victim.Tasks.empty())
+            {
+                TaskIndex = Victim.Tasks.front();
+                Victim.Tasks.pop_front();
+                bFound = true;
+            }
+        }
+
+        if (!bFound)
+        {
+            return false;
+        }
+
+        (*CurrentTask)(TaskIndex);
+        if (RemainingTasks.fetch_sub(1) == 1)
+        {
+            std::lock_guard Lock(Mutex);
+            DoneCondition.notify_all();
+        }
+        return true;
+    }
+}
@@ -0,0 +1,142 @@
+#include "TrajectoryTable.h"
+#include "Curves.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Ballistics
+{
+    namespace
+    {
+        // relative tolerance when deciding if the points are uniformly spaced in time
+        constexpr float UniformTimeStepTolerance = 1e-3f;
+
+        template<typename TDragTable>
+        void SolveTrajectoryTableImpl(const TDragTable& InDragTable, TrajectoryTable& OutTrajectoryTable, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& InSolverParams)
+        {
+            std::vector<TrajectoryDataPoint> Points;
+            Points.emplace_back(InFiringData);
+            SolveTrajectory(InDragTable, Points, InFiringData, Environment, InSolverParams);
+            OutTrajectoryTable.Build(Points, InFiringData.Bullet.GetMassKg());
+        }
+    }
+
+    void TrajectoryTable::Build(std::span<const TrajectoryDataPoint> InPoints, float InMassKg)
+    {
+        MassKg = InMassKg;
+        T.resize(InPoints.size());
+        X.resize(InPoints.size());
+        Y.resize(InPoints.size());
+        Vx.resize(InPoints.size());
+        Vy.resize(InPoints.size());
+        for (size_t n = 0; n < InPoints.size(); ++n)
+        {
+            T[n] = InPoints[n].T;
+            X[n] = InPoints[n].Position.GetX();
+            Y[n] = InPoints[n].Position.GetY();
+            Vx[n] = InPoints[n].Velocity.GetX();
+            Vy[n] = InPoints[n].Velocity.GetY();
+        }
+
+        InvUniformTimeStep = 0.0f;
+        if (IsEmpty())
+        {
+            return;
+        }
+        const float TimeStep = (T.back() - T.front()) / static_cast<float>(T.size() - 1);
+        bool bUniform = TimeStep > 0.0f;
+        for (size_t n = 1; bUniform && n < T.size(); ++n)
+        {
+            bUniform = std::fabs((T[n] - T[n - 1]) - TimeStep) <= UniformTimeStepTolerance * TimeStep;
+        }
+        if (bUniform)
+        {
+            InvUniformTimeStep = 1.0f / TimeStep;
+        }
+    }
+
+    size_t TrajectoryTable::FindSegmentByX(float InX) const
+    {
+        const auto Upper = std::upper_bound(X.begin(), X.end(), InX);
+        const size_t Segment = Upper == X.begin() ? 0 : static_cast<size_t>(Upper - X.begin()) - 1;
+        return std::min(Segment, X.size() - 2);
+    }
+
+    size_t TrajectoryTable::FindSegmentByT(float InT) const
+    {
+        size_t Segment;
+        if (InvUniformTimeStep > 0.0f)
+        {
+            Segment = static_cast<size_t>((InT - T.front()) * InvUniformTimeStep);
+            // the step is only uniform to within rounding
+            Segment = std::min(Segment, T.size() - 2);
+            if (Segment > 0 && InT < T[Segment])
+            {
+                --Segment;
+            }
+            else if (Segment + 2 < T.size() && InT > T[Segment + 1])
+            {
+                ++Segment;
+            }
+            return Segment;
+        }
+        const auto Upper = std::upper_bound(T.begin(), T.end(), InT);
+        Segment = Upper == T.begin() ? 0 : static_cast<size_t>(Upper - T.begin()) - 1;
+        return std::min(Segment, T.size() - 2);
+    }
+
+    TrajectorySample TrajectoryTable::Evaluate(size_t Segment, float Theta) const
+    {
+        const float StepT = T[Segment + 1] - T[Segment];
+        const Curves::CubicHermiteSegment2D Curve(
+            {X[Segment], Y[Segment]}, {X[Segment + 1], Y[Segment + 1]},
+            StepT * Algebra::Vector2D(Vx[Segment], Vy[Segment]), StepT * Algebra::Vector2D(Vx[Segment + 1], Vy[Segment + 1]));
+
+        TrajectorySample Sample;
+        Sample.Point.Position = Curve(Theta);
+        Sample.Point.Velocity = (1.0f / StepT) * Curve.Tangent(Theta);
+        Sample.Point.T = T[Segment] + Theta * StepT;
+        Sample.EnergyJ = 0.5f * MassKg * Sample.Point.Velocity.LengthSq();
+        return Sample;
+    }
+
+    std::optional<TrajectorySample> TrajectoryTable::AtX(float InX) const
+    {
+        if (IsEmpty() || InX < X.front() || InX > X.back())
+        {
+            return std::nullopt;
+        }
+
+        const size_t Segment = FindSegmentByX(InX);
+        const float StepT = T[Segment + 1] - T[Segment];
+        const Curves::CubicHermiteSegment1D CurveX(X[Segment], X[Segment + 1], StepT * Vx[Segment], StepT * Vx[Segment + 1]);
+        // X(Theta) is monotonic and nearly linear over a segment, a couple of Newton iterations are plenty
+        float Theta = (InX - X[Segment]) / (X[Segment + 1] - X[Segment]);
+        for (int n = 0; n < 2; ++n)
+        {
+            Theta = std::clamp(Theta - (CurveX(Theta) - InX) / CurveX.Tangent(Theta), 0.0f, 1.0f);
+        }
+        return Evaluate(Segment, Theta);
+    }
+
+    std::optional<TrajectorySample> TrajectoryTable::AtT(float InT) const
+    {
+        if (IsEmpty() || InT < T.front() || InT > T.back())
+        {
+            return std::nullopt;
+        }
+
+        const size_t Segment = FindSegmentByT(InT);
+        return Evaluate(Segment, (InT - T[Segment]) / (T[Segment + 1] - T[Segment]));
+    }
+
+    void SolveTrajectory(const DragTableType& InDragTable, TrajectoryTable& OutTrajectoryTable, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& InSolverParams)
+    {
+        SolveTrajectoryTableImpl(InDragTable, OutTrajectoryTable, InFiringData, Environment, InSolverParams);
+    }
+
+    void SolveTrajectory(const CompiledDragTable& InDragTable, TrajectoryTable& OutTrajectoryTable, const FiringData& InFiringData, const EnvironmentData& Environment, const SolverParams& InSolverParams)
+    {
+        SolveTrajectoryTableImpl(InDragTable, OutTrajectoryTable, InFiringData, Environment, InSolverParams);
+    }
+}
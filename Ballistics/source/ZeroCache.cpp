@@ -0,0 +1,128 @@
+#include "ZeroCache.h"
+
+#include <cmath>
+
+namespace Ballistics
+{
+    namespace
+    {
+        int32_t Quantise(float Value, float Step)
+        {
+            return static_cast<int32_t>(std::lround(Value / Step));
+        }
+    }
+
+    size_t ZeroCache::KeyHash::operator()(const Key& InKey) const
+    {
+        // FNV-1a over the quantised values and the table contents hash
+        uint64_t Hash = 14695981039346656037ull;
+        for (const int32_t Value : InKey.Values)
+        {
+            Hash = (Hash ^ static_cast<uint32_t>(Value)) * 1099511628211ull;
+        }
+        Hash = (Hash ^ InKey.DragTableHash) * 1099511628211ull;
+        return static_cast<size_t>(Hash);
+    }
+
+    ZeroCache::Key ZeroCache::MakeKey(const FiringData& InFiringData, uint64_t InDragTableHash, float ToleranceM, const EnvironmentData& Environment, const ZeroingParams& Params) const
+    {
+        Key NewKey;
+        NewKey.Values = {
+            Quantise(InFiringData.Bullet.G1BC, Quantisation.BallisticCoefficient),
+            Quantise(InFiringData.Bullet.G7BC, Quantisation.BallisticCoefficient),
+            Quantise(InFiringData.Bullet.MassGr, Quantisation.MassGr),
+            Quantise(InFiringData.Bullet.CallibreMm, Quantisation.CallibreMm),
+            Quantise(InFiringData.MuzzleVelocityMs, Quantisation.MuzzleVelocityMs),
+            Quantise(InFiringData.ZeroDistance, Quantisation.ZeroDistance),
+            Quantise(Environment.TKelvin, Quantisation.TKelvin),
+            Quantise(Environment.AirDensity, Quantisation.AirDensity),
+            Quantise(Environment.Gravity, Quantisation.Gravity),
+            Quantise(ToleranceM, Quantisation.ToleranceM),
+            Quantise(Params.TimeStep, Quantisation.TimeStep),
+            Quantise(Params.MaxTime, Quantisation.MaxTime),
+            static_cast<int32_t>(Params.Method) | (Params.MaxIterations << 8),
+        };
+        NewKey.DragTableHash = InDragTableHash;
+        return NewKey;
+    }
+
+    bool ZeroCache::Find(const Key& InKey, float& OutZeroAngle, ZeroingResult& OutResult)
+    {
+        std::lock_guard Lock(Mutex);
+        const auto It = Index.find(InKey);
+        if (It == Index.end())
+        {
+            ++Misses;
+            return false;
+        }
+        ++Hits;
+        Entries.splice(Entries.begin(), Entries, It->second);
+        OutZeroAngle = It->second->ZeroAngle;
+        OutResult = It->second->Result;
+        return true;
+    }
+
+    void ZeroCache::Insert(const Key& InKey, float InZeroAngle, const ZeroingResult& InResult)
+    {
+        std::lock_guard Lock(Mutex);
+        if (const auto It = Index.find(InKey); It != Index.end())
+        {
+            // another thread zeroed the same key in the meantime
+            Entries.splice(Entries.begin(), Entries, It->second);
+            return;
+        }
+        if (Entries.size() == Capacity)
+        {
+            Index.erase(Entries.back().CacheKey);
+            Entries.pop_back();
+        }
+        Entries.push_front({InKey, InZeroAngle, InResult});
+        Index.emplace(InKey, Entries.begin());
+    }
+
+    ZeroingResult ZeroCache::ZeroIn(FiringData& InOutFiringData, const CompiledDragTable& InDragTable, float ToleranceM, const EnvironmentData& Environment, const ZeroingParams& Params)
+    {
+        const Key EntryKey = MakeKey(InOutFiringData, InDragTable.ContentHash, ToleranceM, Environment, Params);
+        ZeroingResult Result;
+        if (Find(EntryKey, InOutFiringData.ZeroAngle, Result))
+        {
+            Result.Iterations = 0;
+            Result.SolverSteps = 0;
+            return Result;
+        }
+
+        Result = InOutFiringData.ZeroIn(InDragTable, ToleranceM, Environment, Params);
+        if (Result.bConverged)
+        {
+            Insert(EntryKey, InOutFiringData.ZeroAngle, Result);
+        }
+        return Result;
+    }
+
+    void ZeroCache::Clear()
+    {
+        std::lock_guard Lock(Mutex);
+        Entries.clear();
+        Index.clear();
+        Hits = 0;
+        Misses = 0;
+    }
+
+    size_t ZeroCache::Size() const
+    {
+        std::lock_guard Lock(Mutex);
+        return Entries.size();
+    }
+
+    uint64_t ZeroCache::GetHits() const
+    {
+        std::lock_guard Lock(Mutex);
+        return Hits;
+    }
+
+    uint64_t ZeroCache::GetMisses() const
+    {
+        std::lock_guard Lock(Mutex);
+        return Misses;
+    }
+}
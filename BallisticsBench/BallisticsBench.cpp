@@ -0,0 +1,528 @@
+#include <Ballistics.h>
+#include <BulletCatalogue.h>
+#include <BulletData.h>
+#include <Curves.h>
+#include <Data.h>
+#include <DragKernel.h>
+#include <Snapshot.h>
+#include <Solver.h>
+#include <SolverEngines.h>
+
+#include "Benchmark.h"
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    // every random input is drawn from generators seeded with this, so runs are comparable
+    constexpr uint32_t Seed = 20250101u;
+
+    // results are accumulated here so that the measured work can't be optimised away
+    volatile float Sink = 0.0f;
+
+    // the .308 155gr, 871 m/s scenario from BallisticsCalculator/main.cpp
+    struct Scenario
+    {
+        Ballistics::FiringData FiringData;
+        Ballistics::EnvironmentData Environment;
+        float DragFactor = 0.0f;
+
+        Scenario()
+        {
+            FiringData.Bullet.MassGr = 155.0f;
+            FiringData.Bullet.G1BC = 0.29f;
+            FiringData.Bullet.G7BC = 0.275f;
+            FiringData.Bullet.CallibreMm = Ballistics::Callibre308Mm;
+            FiringData.Height = 1.0f;
+            FiringData.ZeroDistance = 200.0f;
+            FiringData.MuzzleVelocityMs = 871.42f;
+
+            Environment.Gravity = -9.81f;
+            Environment.TKelvin = 292.0f;
+            Environment.AirPressure = 101325.0f;
+            Environment.UpdateAirDensityFromTandP();
+
+            DragFactor = 0.5f * Environment.AirDensity * FiringData.Bullet.GetCrossSectionalArea() / FiringData.Bullet.GetMassKg();
+        }
+    };
+
+    std::vector<float> RandomUniform(size_t Count, float Min, float Max)
+    {
+        std::mt19937 Generator(Seed);
+        std::uniform_real_distribution<float> Distribution(Min, Max);
+        std::vector<float> Values(Count);
+        for (float& Value : Values)
+        {
+            Value = Distribution(Generator);
+        }
+        return Values;
+    }
+
+    /**
+     * Drag coefficient lookups at random supersonic to subsonic speeds
+     */
+    template<typename TDragTable>
+    void AddDragCoefficient(std::vector<Benchmark::Benchmark>& Benchmarks, const char* TableName, const TDragTable& DragTable)
+    {
+        const auto Speeds = std::make_shared<const std::vector<float>>(RandomUniform(1024, 100.0f, 1000.0f));
+        Benchmarks.push_back({std::string("GetDragCoefficient/") + TableName, [&DragTable, Speeds]()
+            {
+                float Sum = 0.0f;
+                for (const float Speed : *Speeds)
+                {
+                    Sum += Ballistics::GetDragCoefficient(DragTable, Speed, 292.0f);
+                }
+                Sink = Sink + Sum;
+                return Speeds->size();
+            }});
+        Benchmarks.push_back({std::string("GetDragCoefficientAtMach/") + TableName, [&DragTable, Speeds]()
+            {
+                const float InvSpeedOfSound = 1.0f / Ballistics::GetSpeedOfSound(292.0f);
+                float Sum = 0.0f;
+                for (const float Speed : *Speeds)
+                {
+                    Sum += Ballistics::GetDragCoefficientAtMach(DragTable, Speed * InvSpeedOfSound);
+                }
+                Sink = Sink + Sum;
+                return Speeds->size();
+            }});
+    }
+
+    /**
+     * The drag kernel over the speeds of AddDragCoefficient at each SIMD level, items are lookups
+     */
+    void AddDragCoefficientBatch(std::vector<Benchmark::Benchmark>& Benchmarks, const char* TableName, const Ballistics::CompiledDragTable& DragTable)
+    {
+        const auto Speeds = std::make_shared<const std::vector<float>>(RandomUniform(1024, 100.0f, 1000.0f));
+        const auto Temperatures = std::make_shared<const std::vector<float>>(Speeds->size(), 292.0f);
+        const auto Cd = std::make_shared<std::vector<float>>(Speeds->size());
+        constexpr std::pair<Ballistics::SimdLevel, const char*> Levels[] = {
+            {Ballistics::SimdLevel::Scalar, "scalar"}, {Ballistics::SimdLevel::SSE41, "SSE4.1"}, {Ballistics::SimdLevel::AVX2, "AVX2"}};
+        for (const auto& [Level, LevelName] : Levels)
+        {
+            if (Level > Ballistics::GetSupportedSimdLevel())
+            {
+                continue;
+            }
+            Benchmarks.push_back({std::string("GetDragCoefficients/") + TableName + "/" + LevelName, [&DragTable, Speeds, Temperatures, Cd, Level]()
+                {
+                    Ballistics::GetDragCoefficients(DragTable, *Speeds, *Temperatures, *Cd, Level);
+                    Sink = Sink + (*Cd)[Cd->size() / 2];
+                    return Speeds->size();
+                }});
+        }
+    }
+
+    /**
+     * std::function based RungeKutta4 against the TRungeKutta4 with an inlined functor, integrating flight speed
+     * for 10s in 0.01s steps as SolveTrajectory does
+     */
+    template<typename TDragTable>
+    void AddRungeKutta4(std::vector<Benchmark::Benchmark>& Benchmarks, const char* TableName, const TDragTable& DragTable)
+    {
+        constexpr size_t NumSteps = 1000;
+        const Scenario Scenario;
+
+        const float InvSpeedOfSound = Scenario.Environment.GetInvSpeedOfSound();
+
+        auto TypeErased = std::make_shared<Solver::RungeKutta4>();
+        TypeErased->Initialize(Scenario.FiringData.MuzzleVelocityMs, 0.01f, [&DragTable, Scenario, InvSpeedOfSound](float V, float /* t */) -> float
+            {
+                return -Scenario.DragFactor * Ballistics::GetDragCoefficientAtMach(DragTable, V * InvSpeedOfSound) * (V * V);
+            });
+        Benchmarks.push_back({std::string("RungeKutta4/std::function/") + TableName, [TypeErased]()
+            {
+                TypeErased->Reset();
+                for (size_t n = 0; n < NumSteps; ++n)
+                {
+                    TypeErased->Advance();
+                }
+                Sink = Sink + TypeErased->Y;
+                return NumSteps;
+            }});
+
+        auto Templated = std::make_shared<Solver::TRungeKutta4<float, Ballistics::DragDeceleration<TDragTable>>>();
+        Templated->Initialize(Scenario.FiringData.MuzzleVelocityMs, 0.01f, {&DragTable, Scenario.DragFactor, InvSpeedOfSound});
+        Benchmarks.push_back({std::string("RungeKutta4/TRungeKutta4/") + TableName, [Templated]()
+            {
+                Templated->Reset();
+                for (size_t n = 0; n < NumSteps; ++n)
+                {
+                    Templated->Advance();
+                }
+                Sink = Sink + Templated->Y;
+                return NumSteps;
+            }});
+    }
+
+    /**
+     * The solver interface as it was before the engines were statically dispatched; virtual Completed and Advance
+     * called every step
+     */
+    struct IVirtualSolver
+    {
+        virtual ~IVirtualSolver() = default;
+        virtual bool Completed() const = 0;
+        virtual void Advance() = 0;
+        virtual void Reset(const Ballistics::FiringData& InFiringData) = 0;
+        virtual const Ballistics::TrajectoryDataPoint& GetQ() const = 0;
+    };
+
+    template<typename TSolver>
+    struct TVirtualSolver : IVirtualSolver
+    {
+        template<typename... TArgs>
+        explicit TVirtualSolver(TArgs&&... Args)
+            : Solver(std::forward<TArgs>(Args)...)
+        {
+        }
+        bool Completed() const override
+        {
+            return Solver.Completed();
+        }
+        void Advance() override
+        {
+            Solver.Advance();
+        }
+        void Reset(const Ballistics::FiringData& InFiringData) override
+        {
+            Solver.Reset(InFiringData);
+        }
+        const Ballistics::TrajectoryDataPoint& GetQ() const override
+        {
+            return Solver.Q;
+        }
+
+        TSolver Solver;
+    };
+
+    /**
+     * One engine Advance, statically dispatched and through the virtual interface, integrating 3s of flight in 1ms steps
+     */
+    template<template<typename> typename TEngine>
+    void AddSolverAdvance(std::vector<Benchmark::Benchmark>& Benchmarks, const char* EngineName, Ballistics::IntegratorType Integrator, bool bOtherEngine)
+    {
+        const Scenario Scenario;
+        Ballistics::SolverParams Params;
+        Params.Integrator = Integrator;
+        Params.TimeStep = 0.001f;
+        Params.MaxTime = 3.0f;
+        Params.MinY = std::numeric_limits<float>::lowest();
+
+        using EngineType = TEngine<Ballistics::CompiledDragTable>;
+        auto Static = std::make_shared<EngineType>(Ballistics::CompiledG7, Scenario.FiringData, Scenario.Environment, Params);
+        Benchmarks.push_back({std::string("Advance/static/") + EngineName, [Static, Scenario]()
+            {
+                Static->Reset(Scenario.FiringData);
+                size_t NumSteps = 0;
+                while (!Static->Completed())
+                {
+                    Static->Advance();
+                    ++NumSteps;
+                }
+                Sink = Sink + Static->Q.Position.GetY();
+                return NumSteps;
+            }});
+
+        // chosen at runtime so that the compiler can't see through the interface
+        std::shared_ptr<IVirtualSolver> Virtual;
+        if (bOtherEngine)
+        {
+            Virtual = std::make_shared<TVirtualSolver<Ballistics::HybridEulerRk4Solver<Ballistics::CompiledDragTable>>>(Ballistics::CompiledG7, Scenario.FiringData, Scenario.Environment, Params);
+        }
+        else
+        {
+            Virtual = std::make_shared<TVirtualSolver<EngineType>>(Ballistics::CompiledG7, Scenario.FiringData, Scenario.Environment, Params);
+        }
+        Benchmarks.push_back({std::string("Advance/virtual/") + EngineName, [Virtual, Scenario]()
+            {
+                Virtual->Reset(Scenario.FiringData);
+                size_t NumSteps = 0;
+                while (!Virtual->Completed())
+                {
+                    Virtual->Advance();
+                    ++NumSteps;
+                }
+                Sink = Sink + Virtual->GetQ().Position.GetY();
+                return NumSteps;
+            }});
+    }
+
+    /**
+     * A full SolveTrajectory to 1000m into a reused vector, items are output points (steps for the adaptive integrator)
+     */
+    void AddSolveTrajectory(std::vector<Benchmark::Benchmark>& Benchmarks, const std::string& Name, Ballistics::IntegratorType Integrator, float TimeStep,
+        const Ballistics::CompiledDragTable& DragTable = Ballistics::CompiledG7)
+    {
+        const Scenario Scenario;
+        Ballistics::SolverParams Params;
+        Params.Integrator = Integrator;
+        Params.TimeStep = TimeStep;
+        Params.MaxTime = 10.0f;
+        Params.MaxX = 1000.0f;
+        Params.MinY = std::numeric_limits<float>::lowest();
+
+        auto Points = std::make_shared<std::vector<Ballistics::TrajectoryDataPoint>>();
+        Benchmarks.push_back({"SolveTrajectory/" + Name, [Points, Scenario, Params, &DragTable]()
+            {
+                Points->clear();
+                Ballistics::SolveTrajectory(DragTable, *Points, Scenario.FiringData, Scenario.Environment, Params);
+                Sink = Sink + Points->back().Position.GetY();
+                return Points->size();
+            }});
+    }
+
+    /**
+     * Zeroing at 200m, items are integrator steps
+     */
+    void AddZeroIn(std::vector<Benchmark::Benchmark>& Benchmarks, const char* MethodName, Ballistics::ZeroingMethod Method)
+    {
+        const Scenario Scenario;
+        Ballistics::ZeroingParams Params;
+        Params.Method = Method;
+        Benchmarks.push_back({std::string("ZeroIn/") + MethodName, [Scenario, Params]()
+            {
+                Ballistics::FiringData FiringData = Scenario.FiringData;
+                const Ballistics::ZeroingResult Result = FiringData.ZeroIn(Ballistics::CompiledG7, 0.001f, Scenario.Environment, Params);
+                Sink = Sink + FiringData.ZeroAngle;
+                return Result.SolverSteps;
+            }});
+    }
+
+    void AddParseFromJsonString(std::vector<Benchmark::Benchmark>& Benchmarks)
+    {
+        Benchmarks.push_back({"BulletData::ParseFromJsonString", []()
+            {
+                static const std::string Json = R"({
+                    "bc_fn": "",
+                    "bc_g1": "0.402",
+                    "bc_g7": "0.201",
+                    "company": "Lapua",
+                    "description": "Lapua .308 155gr Scenar GB432",
+                    "diameter_in": "0.308",
+                    "product_name": "Scenar",
+                    "weight_gr": "155"
+                })";
+                Ballistics::BulletData BulletData;
+                BulletData.ParseFromJsonString(Json);
+                Sink = Sink + BulletData.MassGr;
+                return size_t{1};
+            }});
+    }
+
+    /**
+     * A generated catalogue in the layout of the ammolytics files, items are bytes
+     */
+    void AddParseBulletCatalogueJson(std::vector<Benchmark::Benchmark>& Benchmarks)
+    {
+        auto Json = std::make_shared<std::string>();
+        auto Bullets = std::make_shared<std::vector<Ballistics::BulletData>>();
+        const auto GenerateJson = [Json]()
+            {
+                if (!Json->empty())
+                {
+                    return;
+                }
+                *Json = "[";
+                std::mt19937 Generator(Seed);
+                std::uniform_int_distribution<int> Weight(40, 300);
+                for (int n = 0; n < 5000; ++n)
+                {
+                    *Json += n > 0 ? ",\n" : "\n";
+                    *Json += "    {\n"
+                        "        \"bc_fn\": \"\",\n"
+                        "        \"bc_g1\": \"0.4" + std::to_string(n % 100) + "\",\n"
+                        "        \"bc_g7\": \"0.2" + std::to_string(n % 97) + "\",\n"
+                        "        \"company\": \"Company " + std::to_string(n % 20) + "\",\n"
+                        "        \"description\": \"Company .308 " + std::to_string(Weight(Generator)) + "gr Match Hollow Point " + std::to_string(n) + "\",\n"
+                        "        \"diameter_in\": \"0.308\",\n"
+                        "        \"product_name\": \"Match\",\n"
+                        "        \"weight_gr\": \"" + std::to_string(Weight(Generator)) + "\"\n"
+                        "    }";
+                }
+                *Json += "\n]\n";
+            };
+
+        Benchmarks.push_back({"ParseBulletCatalogueJson", [Json, Bullets]()
+            {
+                Bullets->clear();
+                Ballistics::ParseBulletCatalogueJson(*Json, *Bullets);
+                Sink = Sink + Bullets->back().MassGr;
+                return Json->size();
+            }, true, GenerateJson});
+
+        // the same catalogue from a snapshot, items are the bytes of the JSON it replaces
+        const std::filesystem::path SnapshotPath = std::filesystem::temp_directory_path() / "BallisticsBenchCatalogue.snap";
+        auto Snapshot = std::make_shared<Ballistics::Snapshot>();
+        Benchmarks.push_back({"Snapshot::Open", [Json, SnapshotPath, Snapshot]()
+            {
+                Snapshot->Open(SnapshotPath);
+                Sink = Sink + Snapshot->GetCatalogue().GetField(Ballistics::BulletCatalogue::IndexField::MassGr).back();
+                return Json->size();
+            }, true, [GenerateJson, Json, Bullets, SnapshotPath]()
+            {
+                GenerateJson();
+                Bullets->clear();
+                Ballistics::ParseBulletCatalogueJson(*Json, *Bullets);
+                const Ballistics::SnapshotDragTable DragTables[] = {{"G1", &Ballistics::CompiledG1}, {"G7", &Ballistics::CompiledG7}};
+                Ballistics::WriteSnapshot(SnapshotPath, Ballistics::BulletCatalogue(*Bullets), DragTables);
+            }});
+    }
+
+    /**
+     * "all .308 bullets 150-180gr with G7 BC over 0.25" over a random 20000 bullet catalogue, indexed against scanning
+     * the BulletData array; items are bullets in the catalogue
+     */
+    void AddBulletCatalogueQuery(std::vector<Benchmark::Benchmark>& Benchmarks)
+    {
+        auto Bullets = std::make_shared<std::vector<Ballistics::BulletData>>();
+        auto Catalogue = std::make_shared<Ballistics::BulletCatalogue>();
+        const auto GenerateCatalogue = [Bullets, Catalogue]()
+            {
+                if (!Bullets->empty())
+                {
+                    return;
+                }
+                std::mt19937 Generator(Seed);
+                std::uniform_real_distribution<float> Unit(0.0f, 1.0f);
+                constexpr float Callibres[] = {5.70f, 6.17f, 6.71f, 7.04f, 7.82f, 8.59f};
+                Bullets->resize(20000);
+                for (size_t n = 0; n < Bullets->size(); ++n)
+                {
+                    Ballistics::BulletData& Bullet = (*Bullets)[n];
+                    Bullet.CallibreMm = Callibres[n % std::size(Callibres)];
+                    Bullet.MassGr = std::round(50.0f + 250.0f * Unit(Generator));
+                    Bullet.G1BC = 0.2f + 0.5f * Unit(Generator);
+                    Bullet.G7BC = 0.5f * Bullet.G1BC;
+                    Bullet.Company = "Company " + std::to_string(n % 20);
+                    Bullet.Description = Bullet.Company + " bullet " + std::to_string(n);
+                }
+                *Catalogue = Ballistics::BulletCatalogue(*Bullets);
+            };
+        const Ballistics::BulletQuery Query{.CallibreMm = {7.8f, 7.85f}, .MassGr = {150.0f, 180.0f}, .G7BC = {0.25f}};
+
+        auto Indices = std::make_shared<std::vector<uint32_t>>();
+        Benchmarks.push_back({"BulletCatalogue::Query", [Catalogue, Query, Indices]()
+            {
+                Catalogue->Query(Query, *Indices);
+                Sink = Sink + static_cast<float>(Indices->size());
+                return Catalogue->Size();
+            }, false, GenerateCatalogue});
+        Benchmarks.push_back({"BulletCatalogue::Query/linear scan", [Bullets, Query, Indices]()
+            {
+                Indices->clear();
+                for (size_t n = 0; n < Bullets->size(); ++n)
+                {
+                    const Ballistics::BulletData& Bullet = (*Bullets)[n];
+                    if (Query.CallibreMm.Contains(Bullet.CallibreMm) && Query.MassGr.Contains(Bullet.MassGr) && Query.G7BC.Contains(Bullet.G7BC))
+                    {
+                        Indices->push_back(static_cast<uint32_t>(n));
+                    }
+                }
+                Sink = Sink + static_cast<float>(Indices->size());
+                return Bullets->size();
+            }, false, GenerateCatalogue});
+    }
+
+    void AddCatmullRom(std::vector<Benchmark::Benchmark>& Benchmarks)
+    {
+        const Curves::CatmullRomSegment2D Segment({0.0f, 0.0f}, {1.0f, 2.0f}, {3.0f, 1.5f}, {4.0f, 4.0f});
+        const auto Ts = std::make_shared<const std::vector<float>>(RandomUniform(1024, 0.0f, 1.0f));
+        Benchmarks.push_back({"CatmullRom/Evaluate", [Segment, Ts]()
+            {
+                Algebra::Vector2D Sum;
+                for (const float T : *Ts)
+                {
+                    Sum += Segment(T);
+                }
+                Sink = Sink + Sum.GetX();
+                return Ts->size();
+            }});
+
+        auto Samples = std::make_shared<std::vector<Algebra::Vector2D>>();
+        Benchmarks.push_back({"CatmullRom/SampleAdaptively", [Segment, Samples]()
+            {
+                Samples->clear();
+                Segment.SampleAdaptively(*Samples, 0.0f, 1.0f, 0.001f);
+                Sink = Sink + Samples->back().GetX();
+                return Samples->size();
+            }});
+        Benchmarks.push_back({"CatmullRom/SampleWithFwdDifference", [Segment, Samples]()
+            {
+                Samples->clear();
+                Segment.SampleWithFwdDifference(*Samples, 0.0f, 1.0f, 1.0f / 1024.0f);
+                Sink = Sink + Samples->back().GetX();
+                return Samples->size();
+            }});
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Benchmark::Options Options;
+    if (!Benchmark::ParseOptions(argc, argv, Options))
+    {
+        std::fprintf(stderr, "usage: BallisticsBench [--filter=substring] [--json=path] [--min_time=seconds]\n");
+        return 1;
+    }
+
+    std::vector<Benchmark::Benchmark> Benchmarks;
+    AddDragCoefficient(Benchmarks, "G7", Ballistics::G7);
+    AddDragCoefficient(Benchmarks, "CompiledG7", Ballistics::CompiledG7);
+    // resampled to a uniform Mach grid, as for a radar curve with irregular knots
+    const Ballistics::CompiledDragTable UniformG7(Ballistics::CompiledG7.Mach, Ballistics::CompiledG7.Cd, {.NumUniformKnots = 501});
+    AddDragCoefficient(Benchmarks, "CompiledG7/uniform", UniformG7);
+    const Ballistics::CompiledDragTable CubicG7(Ballistics::CompiledG7.Mach, Ballistics::CompiledG7.Cd,
+        {.Extrapolation = Ballistics::DragExtrapolation::Legacy, .Interpolation = Ballistics::DragInterpolation::MonotoneCubic});
+    AddDragCoefficient(Benchmarks, "CompiledG7/monotone cubic", CubicG7);
+    AddDragCoefficientBatch(Benchmarks, "CompiledG7", Ballistics::CompiledG7);
+    AddDragCoefficientBatch(Benchmarks, "CompiledG7/monotone cubic", CubicG7);
+    AddDragCoefficientBatch(Benchmarks, "CompiledG7/uniform", UniformG7);
+    AddRungeKutta4(Benchmarks, "G7", Ballistics::G7);
+    AddRungeKutta4(Benchmarks, "CompiledG7", Ballistics::CompiledG7);
+
+    // never true, but unknown to the compiler
+    const bool bOtherEngine = argc > 100;
+    AddSolverAdvance<Ballistics::HybridEulerRk4Solver>(Benchmarks, "HybridEulerRk4", Ballistics::IntegratorType::HybridEulerRk4, bOtherEngine);
+    AddSolverAdvance<Ballistics::PointMass3DSolver>(Benchmarks, "PointMass3D", Ballistics::IntegratorType::PointMass3D, bOtherEngine);
+
+    AddSolveTrajectory(Benchmarks, "HybridEulerRk4/10ms", Ballistics::IntegratorType::HybridEulerRk4, 0.01f);
+    AddSolveTrajectory(Benchmarks, "HybridEulerRk4/1ms", Ballistics::IntegratorType::HybridEulerRk4, 0.001f);
+    AddSolveTrajectory(Benchmarks, "HybridEulerRk4/0.1ms", Ballistics::IntegratorType::HybridEulerRk4, 0.0001f);
+    AddSolveTrajectory(Benchmarks, "PointMass3D/1ms", Ballistics::IntegratorType::PointMass3D, 0.001f);
+    AddSolveTrajectory(Benchmarks, "DormandPrince45", Ballistics::IntegratorType::DormandPrince45, 0.001f);
+    AddSolveTrajectory(Benchmarks, "DormandPrince45/monotone cubic", Ballistics::IntegratorType::DormandPrince45, 0.001f, CubicG7);
+
+    AddZeroIn(Benchmarks, "Bisection", Ballistics::ZeroingMethod::Bisection);
+    AddZeroIn(Benchmarks, "Secant", Ballistics::ZeroingMethod::Secant);
+    AddParseFromJsonString(Benchmarks);
+    AddParseBulletCatalogueJson(Benchmarks);
+    AddBulletCatalogueQuery(Benchmarks);
+    AddCatmullRom(Benchmarks);
+
+    std::vector<Benchmark::Result> Results;
+    for (const Benchmark::Benchmark& Benchmark : Benchmarks)
+    {
+        if (!Options.Filter.empty() && Benchmark.Name.find(Options.Filter) == std::string::npos)
+        {
+            continue;
+        }
+        Results.push_back(Benchmark::Run(Benchmark, Options.MinTimeS));
+        Benchmark::PrintResult(Results.back());
+    }
+
+    if (!Options.JsonPath.empty() && !Benchmark::WriteJson(Options.JsonPath, Results, Options, Seed))
+    {
+        std::fprintf(stderr, "failed to write %s\n", Options.JsonPath.c_str());
+        return 1;
+    }
+    return 0;
+}
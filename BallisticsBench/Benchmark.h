@@ -0,0 +1,207 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace Benchmark
+{
+    /**
+     * @brief A named benchmark; Body runs one iteration and returns the number of items it processed, e.g. steps.
+     */
+    struct Benchmark
+    {
+        std::string Name;
+        std::function<size_t()> Body;
+        // the items are bytes, reported as throughput
+        bool bItemsAreBytes = false;
+        // expensive inputs, built only if the benchmark passes the filter, before the warm-up iteration
+        std::function<void()> Setup = nullptr;
+    };
+
+    struct Result
+    {
+        std::string Name;
+        size_t Iterations = 0;
+        double NsPerIteration = 0.0;
+        double ItemsPerIteration = 0.0;
+        bool bItemsAreBytes = false;
+
+        double NsPerItem() const
+        {
+            return ItemsPerIteration > 0.0 ? NsPerIteration / ItemsPerIteration : NsPerIteration;
+        }
+
+        double BytesPerSecond() const
+        {
+            return bItemsAreBytes ? 1e9 / NsPerItem() : 0.0;
+        }
+    };
+
+    struct Options
+    {
+        // only run benchmarks whose name contains Filter
+        std::string Filter;
+        // write the results as JSON to this file as well
+        std::string JsonPath;
+        // each benchmark runs for at least this long after a warm-up iteration
+        double MinTimeS = 0.2;
+    };
+
+    /**
+     * Parse --filter=, --json= and --min_time= in the style of Google Benchmark's command line
+     * @return false on an unknown argument
+     */
+    inline bool ParseOptions(int argc, char** argv, Options& OutOptions)
+    {
+        for (int n = 1; n < argc; ++n)
+        {
+            const std::string_view Arg(argv[n]);
+            const auto Value = [&Arg](std::string_view Prefix) -> std::string
+                {
+                    return std::string(Arg.substr(Prefix.size()));
+                };
+            if (Arg.starts_with("--filter="))
+            {
+                OutOptions.Filter = Value("--filter=");
+            }
+            else if (Arg.starts_with("--json="))
+            {
+                OutOptions.JsonPath = Value("--json=");
+            }
+            else if (Arg.starts_with("--min_time="))
+            {
+                OutOptions.MinTimeS = std::stod(Value("--min_time="));
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Run Body for at least MinTimeS, growing the batch of iterations timed together until the batch is long enough
+     * for the clock to be accurate
+     */
+    inline Result Run(const Benchmark& InBenchmark, double MinTimeS)
+    {
+        using Clock = std::chrono::steady_clock;
+        Result Result;
+        Result.Name = InBenchmark.Name;
+        Result.bItemsAreBytes = InBenchmark.bItemsAreBytes;
+
+        if (InBenchmark.Setup)
+        {
+            InBenchmark.Setup();
+        }
+        InBenchmark.Body();
+        size_t BatchSize = 1;
+        size_t Items = 0;
+        double ElapsedS = 0.0;
+        while (ElapsedS < MinTimeS)
+        {
+            const auto Start = Clock::now();
+            for (size_t n = 0; n < BatchSize; ++n)
+            {
+                Items += InBenchmark.Body();
+            }
+            const double BatchS = std::chrono::duration<double>(Clock::now() - Start).count();
+            ElapsedS += BatchS;
+            Result.Iterations += BatchSize;
+            if (BatchS < 0.01)
+            {
+                BatchSize *= 2;
+            }
+        }
+        Result.NsPerIteration = 1e9 * ElapsedS / static_cast<double>(Result.Iterations);
+        Result.ItemsPerIteration = static_cast<double>(Items) / static_cast<double>(Result.Iterations);
+        return Result;
+    }
+
+    inline void PrintResult(const Result& InResult)
+    {
+        if (InResult.bItemsAreBytes)
+        {
+            std::printf("%-48s %12.1f ns %12.1f MB/s    %10zu iterations\n", InResult.Name.c_str(), InResult.NsPerIteration, InResult.BytesPerSecond() / (1024.0 * 1024.0), InResult.Iterations);
+            return;
+        }
+        std::printf("%-48s %12.1f ns %12.2f ns/item %10zu iterations\n", InResult.Name.c_str(), InResult.NsPerIteration, InResult.NsPerItem(), InResult.Iterations);
+    }
+
+    // escaped for a JSON string, benchmark names are free text
+    inline std::string EscapeJson(std::string_view Text)
+    {
+        std::string Escaped;
+        Escaped.reserve(Text.size());
+        for (const char Char : Text)
+        {
+            if (Char == '"' || Char == '\\')
+            {
+                Escaped += '\\';
+                Escaped += Char;
+            }
+            else if (static_cast<unsigned char>(Char) < 0x20)
+            {
+                char Buffer[8];
+                std::snprintf(Buffer, sizeof(Buffer), "\\u%04x", static_cast<unsigned>(Char));
+                Escaped += Buffer;
+            }
+            else
+            {
+                Escaped += Char;
+            }
+        }
+        return Escaped;
+    }
+
+    /**
+     * Google Benchmark compatible JSON, so that existing tooling for comparing runs can be used
+     */
+    inline bool WriteJson(const std::string& Path, const std::vector<Result>& InResults, const Options& InOptions, uint32_t Seed)
+    {
+        FILE* File = std::fopen(Path.c_str(), "w");
+        if (!File)
+        {
+            return false;
+        }
+#ifdef NDEBUG
+        constexpr const char* BuildType = "release";
+#else
+        constexpr const char* BuildType = "debug";
+#endif
+        std::fprintf(File, "{\n  \"context\": {\n");
+        std::fprintf(File, "    \"executable\": \"BallisticsBench\",\n");
+        std::fprintf(File, "    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+        std::fprintf(File, "    \"library_build_type\": \"%s\",\n", BuildType);
+        std::fprintf(File, "    \"min_time\": %g,\n", InOptions.MinTimeS);
+        std::fprintf(File, "    \"seed\": %u\n", Seed);
+        std::fprintf(File, "  },\n  \"benchmarks\": [\n");
+        for (size_t n = 0; n < InResults.size(); ++n)
+        {
+            const Result& Result = InResults[n];
+            std::fprintf(File, "    {\n");
+            std::fprintf(File, "      \"name\": \"%s\",\n", EscapeJson(Result.Name).c_str());
+            std::fprintf(File, "      \"run_type\": \"iteration\",\n");
+            std::fprintf(File, "      \"iterations\": %zu,\n", Result.Iterations);
+            std::fprintf(File, "      \"real_time\": %.3f,\n", Result.NsPerIteration);
+            std::fprintf(File, "      \"cpu_time\": %.3f,\n", Result.NsPerIteration);
+            std::fprintf(File, "      \"time_unit\": \"ns\",\n");
+            std::fprintf(File, "      \"items_per_iteration\": %.1f,\n", Result.ItemsPerIteration);
+            if (Result.bItemsAreBytes)
+            {
+                std::fprintf(File, "      \"bytes_per_second\": %.1f,\n", Result.BytesPerSecond());
+            }
+            std::fprintf(File, "      \"ns_per_item\": %.3f\n", Result.NsPerItem());
+            std::fprintf(File, "    }%s\n", n + 1 < InResults.size() ? "," : "");
+        }
+        std::fprintf(File, "  ]\n}\n");
+        std::fclose(File);
+        return true;
+    }
+}
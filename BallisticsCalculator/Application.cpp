@@ -1,9 +1,16 @@
 ﻿
 #include "Application.h"
 #include "Plotter.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numbers>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
-#include <sstream>
 #ifdef WITH_SDL
 //#include <SDL3/SDL_main.h>
 #include <SDL3/SDL.h>
@@ -16,6 +23,8 @@ namespace Application
     OnMouseMoveDelegateType OnMouseMoveDelegate;
     OnAppUpdateDelegateType OnAppUpdateDelegate;
     OnMouseButtonDelegateType OnMouseButtonDelegate;
+    // the first frame is always drawn; set from any thread, cleared by the loop
+    std::atomic<bool> bRedrawRequested = true;
 
     void SetMouseMoveDelegate(OnMouseMoveDelegateType&& InOnMouseMoveDelegate)
     {
@@ -32,6 +41,19 @@ namespace Application
         OnMouseButtonDelegate = std::move(InOnMouseButtonDelegate);
     }
 
+    void RequestRedraw()
+    {
+        // only the first request since the last frame has to wake the loop, the rest are drawn by the same frame
+        if (!bRedrawRequested.exchange(true))
+        {
+#ifdef WITH_SDL
+            SDL_Event WakeEvent{};
+            WakeEvent.type = SDL_EVENT_USER;
+            SDL_PushEvent(&WakeEvent);
+#endif
+        }
+    }
+
 #ifdef WITH_SDL
     SDL_Window* SdlWindow = NULL;
     SDL_Renderer* SdlRenderer = NULL;
@@ -48,48 +70,189 @@ namespace Application
     struct SdlRendererImpl : Plotter::IRenderer
     {
         SdlRendererImpl() =  default;
-        ~SdlRendererImpl() override = default;
+        ~SdlRendererImpl() override
+        {
+            for (auto& [Key, Text] : TextCache)
+            {
+                SDL_DestroyTexture(Text.Texture);
+            }
+        }
         
         void DrawText(const std::string& Text, const Algebra::Vector2D& Position, ColorRGB Color) override
         {
-            std::istringstream stream(Text);
-            std::string ParsedLine;
-            std::vector<std::string> Lines;
-            while (std::getline(stream, ParsedLine)) {
-                Lines.push_back(ParsedLine);
-            }
-
-            SDL_Color TextColor = {Color.R, Color.G, Color.B, 255};
+            std::string_view Remaining = Text;
             float LineOffset = 0.0f;
-            for (const auto& Line : Lines)
+            while (!Remaining.empty())
             {
-                if ( SDL_Surface* TextSurface = TTF_RenderText_Blended(SdlFont, Line.data(), Line.length(), TextColor) )
+                const size_t LineEnd = std::min(Remaining.find('\n'), Remaining.size());
+                const std::string_view Line = Remaining.substr(0, LineEnd);
+                Remaining.remove_prefix(std::min(LineEnd + 1, Remaining.size()));
+                if (const CachedText* LineText = GetText(Line, Color))
                 {
-                    if ( SDL_Texture* TextTexture = SDL_CreateTextureFromSurface(SdlRenderer, TextSurface) )
-                    {
-                        float TextWidth, TextHeight;
-                        SDL_GetTextureSize(TextTexture, &TextWidth, &TextHeight);
-                        SDL_FRect DestRect = {Position.GetX(), Position.GetY() + LineOffset, TextWidth, TextHeight};
-                        SDL_RenderTexture(SdlRenderer, TextTexture, nullptr, &DestRect);
-                        LineOffset += TextHeight;
-                        SDL_DestroyTexture(TextTexture);           
-                    }
-                    SDL_DestroySurface(TextSurface);
+                    SDL_FRect DestRect = {Position.GetX(), Position.GetY() + LineOffset, LineText->Width, LineText->Height};
+                    SDL_RenderTexture(SdlRenderer, LineText->Texture, nullptr, &DestRect);
+                    LineOffset += LineText->Height;
                 }
             }
         }
+
+        // once per presented frame, drops the text that hasn't been drawn for a while
+        void AgeTextCache()
+        {
+            const bool bOverCapacity = TextCache.size() > MaxCachedTexts;
+            std::erase_if(TextCache, [this, bOverCapacity](auto& Entry)
+                {
+                    const uint64_t Age = FrameNumber - Entry.second.LastUsedFrame;
+                    const bool bEvict = Age > MaxTextAgeFrames || (bOverCapacity && Age > 0);
+                    if (bEvict)
+                    {
+                        SDL_DestroyTexture(Entry.second.Texture);
+                    }
+                    return bEvict;
+                });
+            ++FrameNumber;
+        }
         
         void DrawLine(float x0, float y0, float x1, float y1, ColorRGB Color) override
         {
             SDL_SetRenderDrawColor(SdlRenderer, Color.R, Color.G, Color.B, 255);
             SDL_RenderLine(SdlRenderer, x0, y0, x1, y1);
         }
+
+        void DrawLines(std::span<const Line2D> Lines, ColorRGB Color) override
+        {
+            SDL_SetRenderDrawColor(SdlRenderer, Color.R, Color.G, Color.B, 255);
+            // segments that join up, e.g. ticks drawn along an axis, go as one polyline
+            for (size_t Begin = 0; Begin < Lines.size();)
+            {
+                Points.clear();
+                Points.push_back(ToSdl(Lines[Begin].Start));
+                size_t End = Begin;
+                do
+                {
+                    Points.push_back(ToSdl(Lines[End].End));
+                    ++End;
+                } while (End < Lines.size() && Lines[End].Start == Lines[End - 1].End);
+                SDL_RenderLines(SdlRenderer, Points.data(), static_cast<int>(Points.size()));
+                Begin = End;
+            }
+        }
+
+        void DrawPolyline(std::span<const Algebra::Vector2D> InPoints, ColorRGB Color) override
+        {
+            SDL_SetRenderDrawColor(SdlRenderer, Color.R, Color.G, Color.B, 255);
+            ToSdlPoints(InPoints);
+            SDL_RenderLines(SdlRenderer, Points.data(), static_cast<int>(Points.size()));
+        }
+
+        void DrawPoints(std::span<const Algebra::Vector2D> InPoints, ColorRGB Color) override
+        {
+            SDL_SetRenderDrawColor(SdlRenderer, Color.R, Color.G, Color.B, 255);
+            ToSdlPoints(InPoints);
+            SDL_RenderPoints(SdlRenderer, Points.data(), static_cast<int>(Points.size()));
+        }
+
+        void FillRect(const Range2D& Rect, ColorRGB Color) override
+        {
+            SDL_SetRenderDrawColor(SdlRenderer, Color.R, Color.G, Color.B, 255);
+            const SDL_FRect SdlRect = {Rect.Min.GetX(), Rect.Min.GetY(), Rect.Width(), Rect.Height()};
+            SDL_RenderFillRect(SdlRenderer, &SdlRect);
+        }
+
+        void FillCircles(std::span<const Algebra::Vector2D> Centers, float Radius, ColorRGB Color) override
+        {
+            // a fan of triangles per circle, all circles in one geometry call
+            constexpr int NumSegments = 12;
+            const SDL_FColor VertexColor = {Color.R / 255.0f, Color.G / 255.0f, Color.B / 255.0f, 1.0f};
+            Vertices.clear();
+            Indices.clear();
+            for (const Algebra::Vector2D& Center : Centers)
+            {
+                const int CenterIndex = static_cast<int>(Vertices.size());
+                Vertices.push_back({ToSdl(Center), VertexColor, {0.0f, 0.0f}});
+                for (int n = 0; n < NumSegments; ++n)
+                {
+                    const float Angle = static_cast<float>(n) * (2.0f * static_cast<float>(std::numbers::pi) / NumSegments);
+                    Vertices.push_back({{Center.GetX() + Radius * std::cos(Angle), Center.GetY() + Radius * std::sin(Angle)}, VertexColor, {0.0f, 0.0f}});
+                    Indices.push_back(CenterIndex);
+                    Indices.push_back(CenterIndex + 1 + n);
+                    Indices.push_back(CenterIndex + 1 + (n + 1) % NumSegments);
+                }
+            }
+            SDL_RenderGeometry(SdlRenderer, nullptr, Vertices.data(), static_cast<int>(Vertices.size()), Indices.data(), static_cast<int>(Indices.size()));
+        }
         
         Range2D GetViewportExtents() override
         {
             return ViewportExtents;
         }
+
+    private:
+        // a rasterised line of text
+        struct CachedText
+        {
+            SDL_Texture* Texture = nullptr;
+            float Width = 0.0f;
+            float Height = 0.0f;
+            uint64_t LastUsedFrame = 0;
+        };
+        // labels and legends are drawn every frame, the hover tooltip changes with the mouse
+        static constexpr uint64_t MaxTextAgeFrames = 120;
+        static constexpr size_t MaxCachedTexts = 512;
+        // keyed on the text followed by the color's bytes
+        std::unordered_map<std::string, CachedText> TextCache;
+        std::string TextKey;
+        uint64_t FrameNumber = 0;
+
+        // the line's texture, rasterised on first use, or null if it couldn't be
+        const CachedText* GetText(std::string_view Line, ColorRGB Color)
+        {
+            if (Line.empty())
+            {
+                return nullptr;
+            }
+            TextKey.assign(Line);
+            TextKey.push_back(static_cast<char>(Color.R));
+            TextKey.push_back(static_cast<char>(Color.G));
+            TextKey.push_back(static_cast<char>(Color.B));
+            auto Found = TextCache.find(TextKey);
+            if (Found == TextCache.end())
+            {
+                CachedText Text;
+                const SDL_Color TextColor = {Color.R, Color.G, Color.B, 255};
+                if ( SDL_Surface* TextSurface = TTF_RenderText_Blended(SdlFont, Line.data(), Line.length(), TextColor) )
+                {
+                    Text.Texture = SDL_CreateTextureFromSurface(SdlRenderer, TextSurface);
+                    SDL_DestroySurface(TextSurface);
+                }
+                if (!Text.Texture)
+                {
+                    return nullptr;
+                }
+                SDL_GetTextureSize(Text.Texture, &Text.Width, &Text.Height);
+                Found = TextCache.emplace(TextKey, Text).first;
+            }
+            Found->second.LastUsedFrame = FrameNumber;
+            return &Found->second;
+        }
+
+        // scratch for the batches, kept to avoid allocating every frame
+        std::vector<SDL_FPoint> Points;
+        std::vector<SDL_Vertex> Vertices;
+        std::vector<int> Indices;
+
+        static SDL_FPoint ToSdl(const Algebra::Vector2D& Point)
+        {
+            return {Point.GetX(), Point.GetY()};
+        }
+
+        void ToSdlPoints(std::span<const Algebra::Vector2D> InPoints)
+        {
+            Points.resize(InPoints.size());
+            std::transform(InPoints.begin(), InPoints.end(), Points.begin(), [](const Algebra::Vector2D& Point) { return ToSdl(Point); });
+        }
     };
+    std::shared_ptr<SdlRendererImpl> SdlRendererInstance;
 
     bool Init()
     {
@@ -111,6 +274,11 @@ namespace Application
             return false;
         }
 
+        if (!SDL_SetRenderVSync(SdlRenderer, 1))
+        {
+            SDL_Log("VSync isn't available, frames are unpaced: %s", SDL_GetError());
+        }
+
         SDL_SetRenderDrawColor(SdlRenderer, 255, 255, 255, 255);
         SDL_RenderClear(SdlRenderer);
 
@@ -120,7 +288,8 @@ namespace Application
             return false;
         }
 
-        SetRenderer(std::make_shared<SdlRendererImpl>());
+        SdlRendererInstance = std::make_shared<SdlRendererImpl>();
+        SetRenderer(SdlRendererInstance);
         int ViewportWidth;
         int ViewportHeight;
         SDL_GetRenderOutputSize(SdlRenderer, &ViewportWidth, &ViewportHeight);
@@ -135,8 +304,10 @@ namespace Application
         bool bRunning = true;
         while (bRunning)
         {
+            // sleep until there's input unless a frame is due, then take everything that queued up before drawing once
             SDL_Event Event;
-            while (SDL_PollEvent(&Event))
+            bool bHasEvent = bRedrawRequested ? SDL_PollEvent(&Event) : SDL_WaitEvent(&Event);
+            while (bHasEvent)
             {
                 switch (Event.type)
                 {
@@ -150,8 +321,15 @@ namespace Application
                         SDL_GetRenderOutputSize(SdlRenderer, &ViewportWidth, &ViewportHeight);
                         ViewportExtents.Max.SetX( static_cast<float>(ViewportWidth) );
                         ViewportExtents.Max.SetY( static_cast<float>(ViewportHeight) );
+                        RequestRedraw();
                     }
                     break;
+                case SDL_EVENT_WINDOW_EXPOSED:
+                    RequestRedraw();
+                    break;
+                case SDL_EVENT_USER:
+                    // pushed by RequestRedraw to end the wait, the request is already set
+                    break;
                 case SDL_EVENT_MOUSE_BUTTON_DOWN:
                 case SDL_EVENT_MOUSE_BUTTON_UP:
                     {
@@ -171,21 +349,29 @@ namespace Application
                     break;
                 default:;
                 }
-                
-                SDL_SetRenderDrawColor(SdlRenderer, 255, 255, 255, 255);
-                SDL_RenderClear(SdlRenderer);
-    
-                SDL_SetRenderDrawColor(SdlRenderer, 64, 64, 64, 255);
-                BeginFrame();
-                if (Application::OnAppUpdateDelegate)
-                {
-                    Application::OnAppUpdateDelegate();
-                }
-                RenderFrame();
-                EndFrame();
-    
-                SDL_RenderPresent(SdlRenderer);
+                bHasEvent = SDL_PollEvent(&Event);
+            }
+
+            if (!bRunning || !bRedrawRequested.exchange(false))
+            {
+                continue;
             }
+
+            SDL_SetRenderDrawColor(SdlRenderer, 255, 255, 255, 255);
+            SDL_RenderClear(SdlRenderer);
+
+            SDL_SetRenderDrawColor(SdlRenderer, 64, 64, 64, 255);
+            BeginFrame();
+            if (Application::OnAppUpdateDelegate)
+            {
+                Application::OnAppUpdateDelegate();
+            }
+            RenderFrame();
+            EndFrame();
+            SdlRendererInstance->AgeTextCache();
+
+            // paced by vsync where the renderer has it
+            SDL_RenderPresent(SdlRenderer);
         }
     }
 #else
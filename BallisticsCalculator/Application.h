@@ -11,6 +11,9 @@ namespace Application
     void SetMouseMoveDelegate(OnMouseMoveDelegateType&& OnMouseMoveDelegate);
     void SetAppUpdateDelegate(OnAppUpdateDelegateType&& OnAppUpdateDelegate);
     void SetMouseButtonDelegate(OnMouseButtonDelegateType&& OnMouseButtonDelegate);
+    // frames are only drawn when requested; resizes and exposes request one, the delegates must when they change what's shown.
+    // Safe to call from any thread, it wakes the loop if it's waiting for input
+    void RequestRedraw();
     bool Init();
     void Run();
 }
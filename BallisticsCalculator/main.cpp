@@ -7,6 +7,7 @@
 #include "Plotter.h"
 
 #include "Ballistics.h"
+#include "ZeroCache.h"
 
 using namespace Plotter;
 namespace
@@ -14,6 +15,8 @@ namespace
     Ballistics::BulletData BulletData;
     Ballistics::EnvironmentData Environment;
     Ballistics::FiringData FiringData;
+    // Solve zeroes for both tables each time, the zero is only solved again when the load or conditions change
+    Ballistics::ZeroCache ZeroCache;
     std::vector<Ballistics::TrajectoryDataPoint> G1TrajectoryDataPoints;
     std::vector<Ballistics::TrajectoryDataPoint> G7TrajectoryDataPoints;
     Curve2D::PointInfo SelectedCurvePointInfo;
@@ -128,18 +131,18 @@ namespace
         // roughly one inch at 100m etc
         const float ToleranceM = (2.0f * (FiringData.ZeroDistance * 0.01f)) / 100.0f;
 
-        FiringData.ZeroIn(Ballistics::G1, ToleranceM, Environment);
+        ZeroCache.ZeroIn(FiringData, Ballistics::CompiledG1, ToleranceM, Environment);
         Ballistics::SolverParams Solver;
         Solver.MaxTime = 10.0f;
         Solver.TimeStep = 0.01f;
         Solver.MaxX = 300.0f;
-        Ballistics::SolveTrajectory(Ballistics::G1, G1TrajectoryDataPoints, FiringData, Environment, Solver);
+        Ballistics::SolveTrajectory(Ballistics::CompiledG1, G1TrajectoryDataPoints, FiringData, Environment, Solver);
 
-        FiringData.ZeroIn(Ballistics::G7, ToleranceM, Environment);
+        ZeroCache.ZeroIn(FiringData, Ballistics::CompiledG7, ToleranceM, Environment);
         Solver.MaxTime = 10.0f;
         Solver.TimeStep = 0.01f;
         Solver.MaxX = 300.0f;
-        Ballistics::SolveTrajectory(Ballistics::G7, G7TrajectoryDataPoints, FiringData, Environment, Solver);
+        Ballistics::SolveTrajectory(Ballistics::CompiledG7, G7TrajectoryDataPoints, FiringData, Environment, Solver);
     }
 
 }
@@ -156,6 +159,11 @@ int main(int /*argc*/, char** /*argv*/)
     {
         PlotPtr Plot = ViewportPointInPlot(Point, 1, [](const Curve2D::PointInfo& PointInfo)
         {
+            // the tooltip only changes when the nearest point does
+            if (!bCurveSelected || SelectedCurvePointInfo.MetaDataTag != PointInfo.MetaDataTag)
+            {
+                Application::RequestRedraw();
+            }
             SelectedCurvePointInfo = PointInfo;
             bCurveSelected = true;
         });
@@ -116,6 +116,120 @@ namespace Algebra
         }
     };
 
+    class Vector3D
+    {
+        float X = 0.0f;
+        float Y = 0.0f;
+        float Z = 0.0f;
+    public:
+        Vector3D() = default;
+        ~Vector3D() = default;
+        constexpr Vector3D(float InX, float InY, float InZ) : X(InX), Y(InY), Z(InZ) {}
+        constexpr Vector3D(const Vector3D& Rhs) = default;
+        constexpr Vector3D& operator=(const Vector3D& Rhs) = default;
+        constexpr Vector3D(Vector3D&& Rhs) = default;
+        constexpr Vector3D& operator=(Vector3D&& Rhs) = default;
+
+        constexpr float GetX() const { return X; }
+        constexpr float GetY() const { return Y; }
+        constexpr float GetZ() const { return Z; }
+        constexpr void SetX(float InX) { X = InX; }
+        constexpr void SetY(float InY) { Y = InY; }
+        constexpr void SetZ(float InZ) { Z = InZ; }
+        constexpr void Set(float InX, float InY, float InZ)
+        {
+            X = InX;
+            Y = InY;
+            Z = InZ;
+        }
+        Vector3D& Normalize()
+        {
+            float Length = this->LengthSq();
+            if (Length > 0.0f)
+            {
+                float InvLength = 1.0f / std::sqrt(Length);
+                X *= InvLength;
+                Y *= InvLength;
+                Z *= InvLength;
+            }
+            return *this;
+        }
+
+        constexpr Vector3D& operator+=(const Vector3D& InPoint)
+        {
+            X += InPoint.X;
+            Y += InPoint.Y;
+            Z += InPoint.Z;
+            return *this;
+        }
+
+        constexpr Vector3D& operator-=(const Vector3D& InPoint)
+        {
+            X -= InPoint.X;
+            Y -= InPoint.Y;
+            Z -= InPoint.Z;
+            return *this;
+        }
+
+        constexpr Vector3D& operator*=(float InScalar)
+        {
+            X *= InScalar;
+            Y *= InScalar;
+            Z *= InScalar;
+            return *this;
+        }
+
+        constexpr Vector3D operator-() const
+        {
+            return {-X, -Y, -Z};
+        }
+
+        constexpr Vector3D operator*(float InScalar) const
+        {
+            return {X * InScalar, Y * InScalar, Z * InScalar};
+        }
+
+        constexpr bool operator==(const Vector3D& Rhs) const
+        {
+            return X == Rhs.X && Y == Rhs.Y && Z == Rhs.Z;
+        }
+
+        friend constexpr Vector3D operator*(float InScalar, const Vector3D& InPoint)
+        {
+            return {InPoint.X * InScalar, InPoint.Y * InScalar, InPoint.Z * InScalar};
+        }
+
+        friend constexpr Vector3D operator+(const Vector3D& Lhs, const Vector3D& Rhs)
+        {
+            return {Lhs.X + Rhs.X, Lhs.Y + Rhs.Y, Lhs.Z + Rhs.Z};
+        }
+
+        friend constexpr Vector3D operator-(const Vector3D& Lhs, const Vector3D& Rhs)
+        {
+            return {Lhs.X - Rhs.X, Lhs.Y - Rhs.Y, Lhs.Z - Rhs.Z};
+        }
+
+        constexpr float Dot(const Vector3D& Rhs) const
+        {
+            return X * Rhs.X + Y * Rhs.Y + Z * Rhs.Z;
+        }
+
+        constexpr Vector3D Cross(const Vector3D& Rhs) const
+        {
+            return {Y * Rhs.Z - Z * Rhs.Y, Z * Rhs.X - X * Rhs.Z, X * Rhs.Y - Y * Rhs.X};
+        }
+
+        constexpr float LengthSq() const
+        {
+            return this->Dot(*this);
+        }
+
+        bool NearlyEqual(const Vector3D& Rhs) const
+        {
+            return MathLib::NearlyEqual(X, Rhs.X) && MathLib::NearlyEqual(Y, Rhs.Y) && MathLib::NearlyEqual(Z, Rhs.Z);
+        }
+    };
+
     class Matrix2D
     {
         float Elements[2][2] =
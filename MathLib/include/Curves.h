@@ -141,6 +141,55 @@ namespace Curves
     using CatmullRomSegment1D = TCatmullRomSegment<float>;
     using CatmullRomSegment2D = TCatmullRomSegment<Algebra::Vector2D>;
 
+    /**
+     * @brief Represents a single cubic Hermite segment between two points with given tangents.
+     *
+     * The segment interpolates P0 at t=0 and P1 at t=1 with tangents M0 and M1 (derivatives with respect to t),
+     * which makes it the natural interpolant for sampled trajectories where the velocity at each point is known.
+     */
+    template<typename T>
+    struct TCubicHermiteSegment
+    {
+        TCubicHermiteSegment() = default;
+        constexpr TCubicHermiteSegment(T P0, T P1, T M0, T M1)
+        {
+            SetCoefficients(P0, P1, M0, M1);
+        }
+
+        constexpr TCubicHermiteSegment& SetCoefficients(T P0, T P1, T M0, T M1)
+        {
+            C0 = P0;
+            C1 = M0;
+            C2 = -3.0f * P0 + -2.0f * M0 + 3.0f * P1 + -1.0f * M1;
+            C3 = 2.0f * P0 + M0 + -2.0f * P1 + M1;
+            return *this;
+        }
+
+        // evaluate curve at t
+        constexpr T operator()(float t) const
+        {
+            return C0 + t * (C1 + t * (C2 + t * C3));
+        }
+
+        T At(float t) const
+        {
+            return this->operator()(t);
+        }
+
+        constexpr T Tangent(float t) const
+        {
+            return C1 + t * (2.0f * C2 + (3.0f * t) * C3);
+        }
+
+    private:
+        T C0;
+        T C1;
+        T C2;
+        T C3;
+    };
+    using CubicHermiteSegment1D = TCubicHermiteSegment<float>;
+    using CubicHermiteSegment2D = TCubicHermiteSegment<Algebra::Vector2D>;
+
     template<typename T>
     constexpr T TCatmullRomSegment<T>::Normal(float t) const requires (HasDotProduct<T>)
     {
@@ -0,0 +1,92 @@
+#include <BulletCatalogue.h>
+#include <BulletData.h>
+#include <Data.h>
+#include <DragCurve.h>
+#include <Snapshot.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// converts JSON bullet catalogues, with the built-in and any custom drag tables, to a snapshot the calculator can map at startup
+int main(int argc, char** argv)
+{
+    std::vector<std::filesystem::path> Paths;
+    std::vector<std::pair<std::string, Ballistics::CompiledDragTable>> CustomTables;
+    for (int n = 1; n < argc; ++n)
+    {
+        const std::string_view Arg = argv[n];
+        if (!Arg.starts_with("--drag="))
+        {
+            Paths.emplace_back(Arg);
+            continue;
+        }
+        // --drag=Name=curve.csv, clamped outside of the measured Mach range
+        const std::string_view Spec = Arg.substr(7);
+        const size_t Equals = Spec.find('=');
+        Ballistics::DragCurve Curve;
+        if (Equals == std::string_view::npos || Ballistics::LoadDragCurve(Spec.substr(Equals + 1), Curve) != Ballistics::DragCurveStatus::Ok)
+        {
+            std::fprintf(stderr, "failed to load drag curve %s\n", argv[n]);
+            return 1;
+        }
+        // a snapshot can't hold two tables of the same name
+        const std::string_view Name = Spec.substr(0, Equals);
+        const bool bTaken = Name == "G1" || Name == "G7" || std::any_of(CustomTables.begin(), CustomTables.end(), [Name](const auto& Table)
+            {
+                return Table.first == Name;
+            });
+        if (bTaken)
+        {
+            std::fprintf(stderr, "drag table %.*s is already in the snapshot\n", static_cast<int>(Name.size()), Name.data());
+            return 1;
+        }
+        CustomTables.emplace_back(std::string(Name), Curve.Compile());
+    }
+    if (Paths.size() < 2)
+    {
+        std::fprintf(stderr, "usage: SnapshotTool [--drag=Name=curve.csv ...] output.snap catalogue.json [catalogue.json ...]\n");
+        return 1;
+    }
+    const std::filesystem::path OutputPath = Paths.front();
+    const std::vector<std::filesystem::path> InputPaths(Paths.begin() + 1, Paths.end());
+
+    std::vector<Ballistics::BulletData> Bullets;
+    Ballistics::BulletCatalogueLoadStats Stats;
+    if (!Ballistics::LoadBulletCatalogueJson(InputPaths, Bullets, &Stats))
+    {
+        std::fprintf(stderr, "failed to load every catalogue, converting the %zu bullets loaded\n", Bullets.size());
+    }
+    std::printf("parsed %zu bullets, %.1f MB in %.3f s, %.0f MB/s\n", Stats.NumBullets, static_cast<double>(Stats.NumBytes) / 1.0e6, Stats.Seconds, Stats.GetMBPerSecond());
+
+    const Ballistics::BulletCatalogue Catalogue(Bullets);
+    std::vector<Ballistics::SnapshotDragTable> DragTables = {{"G1", &Ballistics::CompiledG1}, {"G7", &Ballistics::CompiledG7}};
+    for (const auto& [Name, Table] : CustomTables)
+    {
+        DragTables.push_back({Name, &Table});
+    }
+    if (!Ballistics::WriteSnapshot(OutputPath, Catalogue, DragTables))
+    {
+        std::fprintf(stderr, "failed to write %s\n", OutputPath.string().c_str());
+        return 1;
+    }
+
+    // reopen it, which is what replaces the parse at startup
+    const auto Start = std::chrono::steady_clock::now();
+    Ballistics::Snapshot Snapshot;
+    const Ballistics::SnapshotStatus Status = Snapshot.Open(OutputPath);
+    const double OpenSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    if (Status != Ballistics::SnapshotStatus::Ok || Snapshot.GetCatalogue().Size() != Catalogue.Size())
+    {
+        std::fprintf(stderr, "failed to reopen %s\n", OutputPath.string().c_str());
+        return 1;
+    }
+    std::printf("wrote %s, %.1f MB, %zu strings, opened in %.3f ms\n", OutputPath.string().c_str(),
+        static_cast<double>(std::filesystem::file_size(OutputPath)) / 1.0e6, Catalogue.GetStrings().Size(), OpenSeconds * 1.0e3);
+    return 0;
+}
@@ -2,9 +2,26 @@
 #include <Curves.h>
 #include <Algebra.h>
 #include <Ballistics.h>
+#include <Plotter.h>
+#include <BulletCatalogue.h>
 #include <BulletData.h>
 #include <Data.h>
+#include <Dispersion.h>
+#include <DragCurve.h>
+#include <DragKernel.h>
+#include <Random.h>
+#include <RangeCard.h>
+#include <Snapshot.h>
+#include <Solver.h>
+#include <TrajectoryTable.h>
+#include <ZeroCache.h>
+#include <array>
 #include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <thread>
 
 namespace
 {
@@ -27,9 +44,233 @@ namespace
             "weight_gr": "110"
         })";
 
-        BulletData.ParseFromJsonString(JsonData);
+        assert(BulletData.ParseFromJsonString(JsonData));
+        assert(BulletData.Company == "Hornady" && BulletData.Name == "V-MAX®");
+        assert(BulletData.MassGr == 110.0f && BulletData.G1BC == 0.29f && BulletData.G7BC == 0.0f);
+        assert(MathLib::NearlyEqual(BulletData.CallibreMm, 0.308f * 25.4f));
+
+        // any layout, escapes, and values which aren't strings
+        Ballistics::BulletData Compact;
+        assert(Compact.ParseFromJsonString(R"({"company":"Sierra","product_name":"MatchKing \"SMK\" \u00ae","weight_gr":168,"tags":["a","}"],"bc_g7":"0.218"})"));
+        assert(Compact.Company == "Sierra" && Compact.Name == "MatchKing \"SMK\" ®");
+        assert(Compact.MassGr == 168.0f && Compact.G7BC == 0.218f);
+        assert(!Compact.ParseFromJsonString("not json"));
+
+        // a catalogue is an array of the same objects
+        const std::string Catalogue = "\xEF\xBB\xBF[" + JsonData + R"(, {"company": "Lapua", "weight_gr": "155", "diameter_in": "0.308", "bc_g7": ""}, {}])";
+        std::vector<Ballistics::BulletData> Bullets;
+        Ballistics::BulletCatalogueLoadStats Stats;
+        assert(Ballistics::ParseBulletCatalogueJson(Catalogue, Bullets, &Stats));
+        assert(Bullets.size() == 3 && Stats.NumBullets == 3 && Stats.NumBytes == Catalogue.size());
+        assert(Bullets[0].Description == BulletData.Description && Bullets[1].Company == "Lapua" && Bullets[1].MassGr == 155.0f);
+        assert(Bullets[2].Company.empty());
+        assert(!Ballistics::ParseBulletCatalogueJson(R"([{"company": "Lapua"}, {"company": )", Bullets));
+        assert(Bullets.size() == 4);
+
+        // loaded from memory mapped files, appending
+        const std::filesystem::path Paths[2] = {
+            std::filesystem::temp_directory_path() / "BallisticsTestCatalogue0.json",
+            std::filesystem::temp_directory_path() / "BallisticsTestCatalogue1.json"};
+        for (const std::filesystem::path& Path : Paths)
+        {
+            std::ofstream(Path, std::ios::binary) << Catalogue;
+        }
+        Bullets.clear();
+        assert(Ballistics::LoadBulletCatalogueJson(Paths, Bullets, &Stats));
+        assert(Bullets.size() == 6 && Stats.NumBytes == 2 * Catalogue.size());
+        assert(Bullets[3].Name == BulletData.Name && Bullets[4].MassGr == 155.0f);
+        for (const std::filesystem::path& Path : Paths)
+        {
+            std::filesystem::remove(Path);
+        }
+        assert(!Ballistics::LoadBulletCatalogueJson(Paths[0], Bullets));
+        assert(Bullets.size() == 6);
     }
     
+    void TestBulletCatalogue()
+    {
+        // random catalogue, with a third of the bullets lacking a G7 BC as in the ammolytics data
+        std::mt19937 Generator(7);
+        std::uniform_real_distribution<float> Unit(0.0f, 1.0f);
+        // diameters as loaded from the catalogue, .308 is 7.82mm
+        constexpr float Callibres[] = {5.70f, 6.71f, 0.308f * 25.4f, 8.59f};
+        const char* Companies[] = {"Hornady", "Lapua", "Sierra"};
+        std::vector<Ballistics::BulletData> Bullets(2000);
+        for (size_t n = 0; n < Bullets.size(); ++n)
+        {
+            Ballistics::BulletData& Bullet = Bullets[n];
+            Bullet.CallibreMm = Callibres[n % std::size(Callibres)];
+            Bullet.MassGr = std::round(50.0f + 250.0f * Unit(Generator));
+            Bullet.G1BC = 0.2f + 0.5f * Unit(Generator);
+            Bullet.G7BC = n % 3 == 0 ? 0.0f : 0.5f * Bullet.G1BC;
+            Bullet.Company = Companies[n % std::size(Companies)];
+            Bullet.Name = "Match";
+            Bullet.Description = Bullet.Company + " " + std::to_string(n);
+        }
+
+        Ballistics::BulletCatalogue Catalogue;
+        Catalogue.Add(Bullets);
+        assert(Catalogue.Size() == Bullets.size() && !Catalogue.IsIndexed());
+        // each company and the name once, every description
+        assert(Catalogue.GetStrings().Size() == std::size(Companies) + 1 + Bullets.size());
+        const Ballistics::BulletData Bullet = Catalogue.GetBullet(1234);
+        assert(Bullet.Description == Bullets[1234].Description && Bullet.Company == Bullets[1234].Company);
+        assert(Bullet.MassGr == Bullets[1234].MassGr && Bullet.G7BC == Bullets[1234].G7BC);
+
+        // all .308 bullets 150-180gr with a G7 BC over 0.25, indexed or not the same as checking every bullet
+        const Ballistics::BulletQuery Query{.CallibreMm = {7.8f, 7.85f}, .MassGr = {150.0f, 180.0f}, .G7BC = {0.25f}};
+        std::vector<uint32_t> Expected;
+        for (size_t n = 0; n < Bullets.size(); ++n)
+        {
+            if (Bullets[n].CallibreMm >= 7.8f && Bullets[n].CallibreMm <= 7.85f && Bullets[n].MassGr >= 150.0f
+                && Bullets[n].MassGr <= 180.0f && Bullets[n].G7BC >= 0.25f)
+            {
+                Expected.push_back(static_cast<uint32_t>(n));
+            }
+        }
+        assert(!Expected.empty());
+        assert(Catalogue.Query(Query) == Expected);
+        Catalogue.BuildIndices();
+        assert(Catalogue.Query(Query) == Expected);
+
+        // and by company
+        Ballistics::BulletQuery CompanyQuery = Query;
+        CompanyQuery.Company = "Lapua";
+        const std::vector<uint32_t> Lapua = Catalogue.Query(CompanyQuery);
+        assert(!Lapua.empty() && Lapua.size() < Expected.size());
+        for (const uint32_t Index : Lapua)
+        {
+            assert(Catalogue.GetCompany(Index) == "Lapua");
+        }
+        CompanyQuery.Company = "Nosler";
+        assert(Catalogue.Query(CompanyQuery).empty());
+
+        // nothing in range, and everything
+        assert(Catalogue.Query({.MassGr = {400.0f, 500.0f}}).empty());
+        assert(Catalogue.Query({}).size() == Bullets.size());
+    }
+
+    void TestSnapshot()
+    {
+        std::vector<Ballistics::BulletData> Bullets(500);
+        for (size_t n = 0; n < Bullets.size(); ++n)
+        {
+            Ballistics::BulletData& Bullet = Bullets[n];
+            Bullet.CallibreMm = n % 2 == 0 ? 6.71f : 7.82f;
+            Bullet.MassGr = 100.0f + static_cast<float>(n % 100);
+            Bullet.G1BC = 0.3f + 0.001f * static_cast<float>(n);
+            Bullet.G7BC = 0.5f * Bullet.G1BC;
+            Bullet.Company = n % 3 == 0 ? "Lapua" : "Sierra";
+            Bullet.Name = "Match " + std::to_string(n);
+        }
+        const Ballistics::BulletCatalogue Catalogue(Bullets);
+        const float RadarMach[] = {0.5f, 1.0f, 2.0f};
+        const float RadarCd[] = {0.25f, 0.4f, 0.3f};
+        const Ballistics::CompiledDragTable Radar(RadarMach, RadarCd, {.Interpolation = Ballistics::DragInterpolation::MonotoneCubic});
+        const Ballistics::SnapshotDragTable DragTables[] = {{"G1", &Ballistics::CompiledG1}, {"G7", &Ballistics::CompiledG7}, {"Radar", &Radar}};
+        const std::filesystem::path Path = std::filesystem::temp_directory_path() / "BallisticsTestSnapshot.snap";
+        assert(Ballistics::WriteSnapshot(Path, Catalogue, DragTables));
+
+        {
+            Ballistics::Snapshot Snapshot;
+            assert(Snapshot.Open(Path) == Ballistics::SnapshotStatus::Ok);
+            const Ballistics::BulletCatalogue& Loaded = Snapshot.GetCatalogue();
+            assert(Loaded.Size() == Catalogue.Size() && Loaded.IsIndexed());
+            assert(Loaded.GetBullet(123).Name == "Match 123" && Loaded.GetCompany(123) == "Lapua");
+            const Ballistics::BulletQuery Query{.CallibreMm = {7.8f, 7.85f}, .MassGr = {150.0f, 180.0f}, .Company = "Sierra"};
+            assert(!Catalogue.Query(Query).empty() && Loaded.Query(Query) == Catalogue.Query(Query));
+
+            assert(Snapshot.GetDragTableNames().size() == 3 && !Snapshot.FindDragTable("G2"));
+            const Ballistics::CompiledDragTable* LoadedRadar = Snapshot.FindDragTable("Radar");
+            assert(LoadedRadar->Extrapolation == Ballistics::DragExtrapolation::Clamp && LoadedRadar->Interpolation == Ballistics::DragInterpolation::MonotoneCubic);
+            assert(LoadedRadar->GetAtMach(3.0f) == 0.3f && LoadedRadar->GetAtMach(0.8f) == Radar.GetAtMach(0.8f));
+            const Ballistics::CompiledDragTable* G7 = Snapshot.FindDragTable("G7");
+            assert(G7 && G7->Mach.IsView());
+            for (float Mach = 0.0f; Mach < 5.0f; Mach += 0.01f)
+            {
+                assert(G7->GetAtMach(Mach) == Ballistics::CompiledG7.GetAtMach(Mach));
+            }
+
+            // a copy views the same mapping until it's modified
+            Ballistics::BulletCatalogue Copy = Loaded;
+            Copy.Add(Bullets[0]);
+            assert(Copy.Size() == Loaded.Size() + 1 && Copy.GetStrings().Size() == Loaded.GetStrings().Size());
+            Copy.BuildIndices();
+            assert(Copy.Query({.MassGr = {100.0f, 100.0f}}).size() == Loaded.Query({.MassGr = {100.0f, 100.0f}}).size() + 1);
+        }
+
+        std::string Bytes;
+        {
+            std::ifstream Stream(Path, std::ios::binary);
+            Bytes.assign(std::istreambuf_iterator<char>(Stream), {});
+        }
+        const auto OpenModified = [&Path, &Bytes](size_t Offset, char Value, size_t Size)
+            {
+                std::string Modified = Bytes.substr(0, Size);
+                if (Offset < Modified.size())
+                {
+                    Modified[Offset] = Value;
+                }
+                std::ofstream(Path, std::ios::binary | std::ios::trunc).write(Modified.data(), static_cast<std::streamsize>(Modified.size()));
+                Ballistics::Snapshot Snapshot;
+                return Snapshot.Open(Path);
+            };
+        // magic, version, a section name in the directory, and truncated
+        assert(OpenModified(0, 'X', Bytes.size()) == Ballistics::SnapshotStatus::BadHeader);
+        assert(OpenModified(8, 99, Bytes.size()) == Ballistics::SnapshotStatus::UnsupportedVersion);
+        assert(OpenModified(64, 'X', Bytes.size()) == Ballistics::SnapshotStatus::Corrupt);
+        assert(OpenModified(0, 'B', Bytes.size() - 64) == Ballistics::SnapshotStatus::Corrupt);
+        assert(OpenModified(0, 'B', 16) == Ballistics::SnapshotStatus::BadHeader);
+
+        // drag tables whose lookups would index out of their arrays
+        const auto OpenWithDragTable = [&Path, &Catalogue](const Ballistics::CompiledDragTable& Table)
+            {
+                const Ballistics::SnapshotDragTable Tables[] = {{"Bad", &Table}};
+                assert(Ballistics::WriteSnapshot(Path, Catalogue, Tables));
+                Ballistics::Snapshot Snapshot;
+                return Snapshot.Open(Path);
+            };
+        assert(OpenWithDragTable(Radar) == Ballistics::SnapshotStatus::Ok);
+        Ballistics::CompiledDragTable Bad = Radar;
+        Bad.GridSegment = std::vector<uint32_t>(Radar.GridSegment.size(), static_cast<uint32_t>(Radar.Slope.size()));
+        assert(OpenWithDragTable(Bad) == Ballistics::SnapshotStatus::Corrupt);
+        Bad = Radar;
+        Bad.GridInvStep *= 2.0f;
+        assert(OpenWithDragTable(Bad) == Ballistics::SnapshotStatus::Corrupt);
+        Bad = Radar;
+        Bad.Mach = std::vector<float>{0.5f, 2.0f, 1.0f};
+        assert(OpenWithDragTable(Bad) == Ballistics::SnapshotStatus::Corrupt);
+
+        // a repeated drag table name is refused when writing, and a file with one anyway is corrupt rather than two views of the first
+        const Ballistics::SnapshotDragTable Repeated[] = {{"G1", &Ballistics::CompiledG1}, {"G1", &Radar}};
+        assert(!Ballistics::WriteSnapshot(Path, Catalogue, Repeated));
+        const Ballistics::SnapshotDragTable Distinct[] = {{"G1", &Ballistics::CompiledG1}, {"G2", &Radar}};
+        assert(Ballistics::WriteSnapshot(Path, Catalogue, Distinct));
+        {
+            std::ifstream Stream(Path, std::ios::binary);
+            Bytes.assign(std::istreambuf_iterator<char>(Stream), {});
+        }
+        assert(OpenModified(0, 'B', Bytes.size()) == Ballistics::SnapshotStatus::Ok);
+        // rename the G2 sections in the directory, after the 40 byte header padded to 64, and fix up its checksum
+        uint64_t NumSections = 0;
+        std::memcpy(&NumSections, Bytes.data() + 24, sizeof(NumSections));
+        const size_t DirectorySize = static_cast<size_t>(NumSections) * 72;
+        for (size_t Offset = Bytes.find("drag/G2/", 64); Offset < 64 + DirectorySize; Offset = Bytes.find("drag/G2/", Offset))
+        {
+            Bytes[Offset + 6] = '1';
+        }
+        uint64_t DirectoryChecksum = 14695981039346656037ull;
+        for (size_t n = 64; n < 64 + DirectorySize; ++n)
+        {
+            DirectoryChecksum = (DirectoryChecksum ^ static_cast<uint8_t>(Bytes[n])) * 1099511628211ull;
+        }
+        std::memcpy(Bytes.data() + 32, &DirectoryChecksum, sizeof(DirectoryChecksum));
+        assert(OpenModified(0, 'B', Bytes.size()) == Ballistics::SnapshotStatus::Corrupt);
+        std::filesystem::remove(Path);
+        Ballistics::Snapshot Missing;
+        assert(Missing.Open(Path) == Ballistics::SnapshotStatus::CantOpen && !Missing.IsOpen());
+    }
+
     void TestCatmullRom()
     {
         constexpr Curves::CatmullRomSegment1D Segment(-1.0f, 0.0f, 1.0f, 2.0f);
@@ -105,6 +346,894 @@ namespace
         assert(FiringData.ZeroAngle > 0.0f);
         FiringData.ZeroIn(Ballistics::G1, ToleranceM, Environment);
         assert(FiringData.ZeroAngle > 0.0f);
+
+        const float G1ZeroAngle = FiringData.ZeroAngle;
+        FiringData.ZeroIn(Ballistics::CompiledG1, ToleranceM, Environment);
+        assert(std::fabs(FiringData.ZeroAngle - G1ZeroAngle) <= 1e-5f);
+    }
+
+    void TestZeroingMethods()
+    {
+        Ballistics::EnvironmentData Environment;
+        Environment.Gravity = -9.81f;
+        Environment.TKelvin = 292.0f;
+        Environment.AirPressure = 101325.0f;
+        Environment.UpdateAirDensityFromTandP();
+
+        Ballistics::FiringData FiringData;
+        FiringData.Bullet.MassGr = 155.0f;
+        FiringData.Bullet.G7BC = 0.275f;
+        FiringData.Bullet.CallibreMm = Ballistics::Callibre308Mm;
+        FiringData.MuzzleVelocityMs = 871.42f;
+
+        constexpr float ToleranceM = 0.001f;
+        Ballistics::ZeroingParams Bisection;
+        assert(Bisection.Method == Ballistics::ZeroingMethod::Bisection);
+        Bisection.Method = Ballistics::ZeroingMethod::Bisection;
+        Ballistics::ZeroingParams Secant;
+        Secant.Method = Ballistics::ZeroingMethod::Secant;
+
+        for (const float ZeroDistance : {100.0f, 300.0f, 600.0f})
+        {
+            FiringData.ZeroDistance = ZeroDistance;
+            const Ballistics::ZeroingResult BisectionResult = FiringData.ZeroIn(Ballistics::CompiledG7, ToleranceM, Environment, Bisection);
+            const float BisectionAngle = FiringData.ZeroAngle;
+            assert(BisectionResult.bConverged);
+
+            const Ballistics::ZeroingResult SecantResult = FiringData.ZeroIn(Ballistics::CompiledG7, ToleranceM, Environment, Secant);
+            assert(SecantResult.bConverged);
+            assert(std::fabs(SecantResult.ResidualM) <= ToleranceM);
+            assert(SecantResult.Iterations <= 4);
+            assert(SecantResult.SolverSteps * 3 < BisectionResult.SolverSteps);
+            // the bisection judges the height at the first step past the zero distance, several metres further out
+            assert(std::fabs(FiringData.ZeroAngle - BisectionAngle) <= 1e-4f);
+        }
+
+        // out of reach: reports failure rather than looping forever
+        FiringData.ZeroDistance = 20000.0f;
+        Secant.MaxIterations = 5;
+        assert(!FiringData.ZeroIn(Ballistics::CompiledG7, ToleranceM, Environment, Secant).bConverged);
+        // at the edge of MaxTime the secant stops converging and hands over to the bisection
+        FiringData.ZeroDistance = 2900.0f;
+        Secant.MaxIterations = 50;
+        const Ballistics::ZeroingResult LoftedBisection = FiringData.ZeroIn(Ballistics::CompiledG7, ToleranceM, Environment, Bisection);
+        const float LoftedAngle = FiringData.ZeroAngle;
+        const Ballistics::ZeroingResult LoftedSecant = FiringData.ZeroIn(Ballistics::CompiledG7, ToleranceM, Environment, Secant);
+        assert(LoftedBisection.bConverged && LoftedSecant.bConverged);
+        assert(LoftedSecant.Iterations > 4);
+        assert(std::fabs(FiringData.ZeroAngle - LoftedAngle) <= 1e-4f);
+
+        FiringData.ZeroDistance = 20000.0f;
+        Bisection.MaxIterations = 5;
+        const Ballistics::ZeroingResult BisectionResult = FiringData.ZeroIn(Ballistics::CompiledG7, ToleranceM, Environment, Bisection);
+        assert(!BisectionResult.bConverged && BisectionResult.Iterations == 5);
+    }
+
+    void TestZeroCache()
+    {
+        Ballistics::EnvironmentData Environment;
+        Environment.Gravity = -9.81f;
+        Environment.TKelvin = 292.0f;
+        Environment.AirPressure = 101325.0f;
+        Environment.UpdateAirDensityFromTandP();
+
+        Ballistics::FiringData FiringData;
+        FiringData.Bullet.MassGr = 155.0f;
+        FiringData.Bullet.G7BC = 0.275f;
+        FiringData.Bullet.CallibreMm = Ballistics::Callibre308Mm;
+        FiringData.MuzzleVelocityMs = 871.42f;
+        FiringData.ZeroDistance = 200.0f;
+        constexpr float ToleranceM = 0.001f;
+
+        Ballistics::ZeroCache Cache(2);
+        const Ballistics::ZeroingResult Solved = Cache.ZeroIn(FiringData, Ballistics::CompiledG7, ToleranceM, Environment);
+        const float ZeroAngle = FiringData.ZeroAngle;
+        assert(Solved.bConverged && Solved.SolverSteps > 0);
+        assert(Cache.GetHits() == 0 && Cache.GetMisses() == 1);
+
+        // same inputs, and inputs within the quantisation step, are lookups
+        FiringData.ZeroAngle = 0.0f;
+        Ballistics::ZeroingResult Cached = Cache.ZeroIn(FiringData, Ballistics::CompiledG7, ToleranceM, Environment);
+        assert(Cached.bConverged && Cached.SolverSteps == 0 && FiringData.ZeroAngle == ZeroAngle);
+        Ballistics::EnvironmentData Warmer = Environment;
+        Warmer.TKelvin += 0.01f;
+        Cached = Cache.ZeroIn(FiringData, Ballistics::CompiledG7, ToleranceM, Warmer);
+        assert(Cached.SolverSteps == 0);
+        assert(Cache.GetHits() == 2 && Cache.GetMisses() == 1);
+
+        // a different drag table is a different key
+        const Ballistics::CompiledDragTable CubicG7(Ballistics::CompiledG7.Mach, Ballistics::CompiledG7.Cd,
+            {.Extrapolation = Ballistics::DragExtrapolation::Legacy, .Interpolation = Ballistics::DragInterpolation::MonotoneCubic});
+        Cached = Cache.ZeroIn(FiringData, CubicG7, ToleranceM, Environment);
+        assert(Cached.SolverSteps > 0 && Cache.GetMisses() == 2 && Cache.Size() == 2);
+
+        // the least recently used entry, the compiled table, is evicted
+        FiringData.ZeroDistance = 300.0f;
+        Cache.ZeroIn(FiringData, Ballistics::CompiledG7, ToleranceM, Environment);
+        assert(Cache.Size() == 2);
+        FiringData.ZeroDistance = 200.0f;
+        Cached = Cache.ZeroIn(FiringData, CubicG7, ToleranceM, Environment);
+        assert(Cached.SolverSteps == 0);
+        Cached = Cache.ZeroIn(FiringData, Ballistics::CompiledG7, ToleranceM, Environment);
+        assert(Cached.SolverSteps > 0 && std::fabs(FiringData.ZeroAngle - ZeroAngle) <= 1e-7f);
+        assert(Cache.GetHits() == 3 && Cache.GetMisses() == 4);
+
+        // a zero that needs more flight time than MaxTime allows is not served from one that had it
+        Ballistics::ZeroingParams ShortFlight;
+        ShortFlight.MaxTime = 0.1f;
+        Cached = Cache.ZeroIn(FiringData, Ballistics::CompiledG7, ToleranceM, Environment, ShortFlight);
+        assert(!Cached.bConverged && Cached.SolverSteps > 0);
+
+        // tables are keyed by contents, not by address: a different curve compiled into the same object is a miss
+        std::vector<float> CurveMach;
+        std::vector<float> CurveCd;
+        for (const auto& [Mach, Cd] : Ballistics::G7)
+        {
+            CurveMach.push_back(Mach);
+            CurveCd.push_back(Cd);
+        }
+        Ballistics::ZeroCache CurveCache;
+        FiringData.ZeroDistance = 300.0f;
+        Ballistics::CompiledDragTable Curve(CurveMach, CurveCd);
+        Cached = CurveCache.ZeroIn(FiringData, Curve, ToleranceM, Environment);
+        const float CurveAngle = FiringData.ZeroAngle;
+        assert(Cached.bConverged && Cached.SolverSteps > 0);
+        for (float& Cd : CurveCd)
+        {
+            Cd *= 3.0f;
+        }
+        Curve = Ballistics::CompiledDragTable(CurveMach, CurveCd);
+        Cached = CurveCache.ZeroIn(FiringData, Curve, ToleranceM, Environment);
+        assert(Cached.bConverged && Cached.SolverSteps > 0 && CurveCache.GetMisses() == 2);
+        const float DraggierAngle = FiringData.ZeroAngle;
+        assert(DraggierAngle > CurveAngle + 1e-3f);
+        Ballistics::ZeroCache FreshCache;
+        FreshCache.ZeroIn(FiringData, Curve, ToleranceM, Environment);
+        assert(FiringData.ZeroAngle == DraggierAngle);
+        // and the same curve compiled again is a hit
+        const Ballistics::CompiledDragTable SameCurve(CurveMach, CurveCd);
+        Cached = CurveCache.ZeroIn(FiringData, SameCurve, ToleranceM, Environment);
+        assert(Cached.SolverSteps == 0 && FiringData.ZeroAngle == DraggierAngle);
+    }
+
+    void TestCompiledDragTable()
+    {
+        constexpr float TemperatureK = 292.0f;
+        for (const auto* Table : {&Ballistics::G1, &Ballistics::G7})
+        {
+            const Ballistics::CompiledDragTable Compiled(*Table);
+            assert(Compiled.Mach.size() == Table->size());
+
+            // speeds from just above 0 to beyond the last entry (Mach 5)
+            for (float Speed = 1.0f; Speed < 2000.0f; Speed += 0.37f)
+            {
+                const float Expected = Ballistics::GetDragCoefficient(*Table, Speed, TemperatureK);
+                const float Actual = Ballistics::GetDragCoefficient(Compiled, Speed, TemperatureK);
+                assert(std::fabs(Expected - Actual) <= 1e-5f);
+            }
+            // exactly on the knots
+            for (const auto& [Mach, Cd] : *Table)
+            {
+                assert(std::fabs(Compiled.GetAtMach(Mach) - Cd) <= 1e-5f);
+            }
+        }
+        assert(Ballistics::CompiledG7.GetAtMach(6.0f) == 0.0f);
+
+        // empty and one knot tables have no segments, NaN has no grid cell
+        assert(Ballistics::CompiledDragTable().GetAtMach(1.0f) == 0.0f);
+        assert(Ballistics::CompiledDragTable(Ballistics::DragTableType{{1.0f, 0.3f}}).GetAtMach(1.0f) == 0.0f);
+        assert(Ballistics::CompiledG7.GetAtMach(std::numeric_limits<float>::quiet_NaN()) == 0.0f);
+        assert(!std::isnan(Ballistics::CompiledG1.GetAtMach(std::numeric_limits<float>::quiet_NaN())));
+
+        // custom knots out of order or without a Cd each are left empty
+        const float UnorderedMach[] = {0.5f, 1.0f, 0.9f};
+        const float UnorderedCd[] = {0.3f, 0.4f, 0.35f};
+        assert(Ballistics::CompiledDragTable(UnorderedMach, UnorderedCd).IsEmpty());
+        assert(Ballistics::CompiledDragTable(UnorderedMach, UnorderedCd, {.NumUniformKnots = 11}).IsEmpty());
+        assert(Ballistics::CompiledDragTable(std::span(UnorderedMach, 2), UnorderedCd).IsEmpty());
+
+        // G1 starts at Mach 0, there is nothing below it to scale down to
+        assert(Ballistics::CompiledG1.GetAtMach(-0.1f) == Ballistics::CompiledG1.Cd.front());
+    }
+
+    void TestDragCurve()
+    {
+        // any separator, comments, a header and further columns
+        Ballistics::DragCurve Curve;
+        assert(Ballistics::ParseDragCurveCsv("\xEF\xBB\xBF# radar\r\nMach,Cd,Sigma\r\n0.5,0.25,0.01\r\n\r\n1.0;0.40\n 2.0\t0.30\n", Curve) == Ballistics::DragCurveStatus::Ok);
+        assert(Curve.Mach == std::vector<float>({0.5f, 1.0f, 2.0f}) && Curve.Cd == std::vector<float>({0.25f, 0.4f, 0.3f}));
+        Ballistics::DragCurve JsonCurve;
+        assert(Ballistics::ParseDragCurveJson(R"({"name": "test", "mach": [0.5, "1.0", 2], "cd": [0.25, 0.4, 0.3]})", JsonCurve) == Ballistics::DragCurveStatus::Ok);
+        assert(JsonCurve.Mach == Curve.Mach && JsonCurve.Cd == Curve.Cd);
+
+        // rejected, with the offending knot
+        size_t Knot = 0;
+        assert(Ballistics::ParseDragCurveCsv("0.5,0.25\n1.0,0.4\n1.0,0.3\n", Curve) == Ballistics::DragCurveStatus::NonMonotonicMach);
+        assert(Curve.Validate(&Knot) == Ballistics::DragCurveStatus::NonMonotonicMach && Knot == 2);
+        assert(Ballistics::ParseDragCurveCsv("0.5,0.25\n1.0,-0.4\n", Curve) == Ballistics::DragCurveStatus::InvalidValue);
+        assert(Ballistics::ParseDragCurveCsv("Mach,Cd\n0.5,0.25\n", Curve) == Ballistics::DragCurveStatus::TooFewKnots);
+        assert(Ballistics::ParseDragCurveCsv("0.5,0.25\nfoo\n1.0,0.4\n", Curve) == Ballistics::DragCurveStatus::Malformed);
+        assert(Ballistics::ParseDragCurveJson(R"({"mach": [0.5, 1.0], "cd": [0.25]})", Curve) == Ballistics::DragCurveStatus::Malformed);
+        assert(Ballistics::ParseDragCurveJson(R"({"mach": [0.5, 1.0], "cd": [0.25, 0.3])", Curve) == Ballistics::DragCurveStatus::Malformed);
+
+        // the built-in tables, compiled from their knots, with each extrapolation
+        const Ballistics::DragCurve G7{{Ballistics::CompiledG7.Mach.begin(), Ballistics::CompiledG7.Mach.end()}, {Ballistics::CompiledG7.Cd.begin(), Ballistics::CompiledG7.Cd.end()}};
+        assert(G7.Validate() == Ballistics::DragCurveStatus::Ok);
+        const Ballistics::CompiledDragTable Legacy = G7.Compile({.Extrapolation = Ballistics::DragExtrapolation::Legacy});
+        const Ballistics::CompiledDragTable Clamped = G7.Compile();
+        const Ballistics::CompiledDragTable Linear = G7.Compile({.Extrapolation = Ballistics::DragExtrapolation::Linear});
+        for (float Mach = 0.0f; Mach <= 5.0f; Mach += 0.013f)
+        {
+            assert(Legacy.GetAtMach(Mach) == Ballistics::CompiledG7.GetAtMach(Mach));
+            assert(Clamped.GetAtMach(Mach) == Ballistics::CompiledG7.GetAtMach(Mach) && Linear.GetAtMach(Mach) == Clamped.GetAtMach(Mach));
+        }
+        assert(Legacy.GetAtMach(6.0f) == 0.0f && Clamped.GetAtMach(6.0f) == Ballistics::G7.at(5.0f));
+        assert(Linear.GetAtMach(6.0f) < Clamped.GetAtMach(6.0f) && Linear.GetAtMach(100.0f) == 0.0f);
+
+        // a radar curve starting at Mach 0.5
+        const Ballistics::CompiledDragTable Radar = JsonCurve.Compile();
+        assert(Radar.GetAtMach(0.1f) == 0.25f && Radar.GetAtMach(0.75f) == 0.325f && Radar.GetAtMach(3.0f) == 0.3f);
+
+        // resampled to a uniform grid, the error is largest around the knots the grid misses
+        const Ballistics::CompiledDragTable Uniform = G7.Compile({.NumUniformKnots = 1001});
+        assert(Uniform.Mach.size() == 1001 && Uniform.Mach.back() == 5.0f);
+        float MaxError = 0.0f;
+        for (float Mach = 0.0f; Mach <= 5.0f; Mach += 0.0013f)
+        {
+            MaxError = std::max(MaxError, std::fabs(Uniform.GetAtMach(Mach) - Ballistics::CompiledG7.GetAtMach(Mach)));
+        }
+        assert(MaxError < 2e-3f);
+
+        // monotone cubic: through the knots, within the range of each segment's knots, and a continuous slope
+        const Ballistics::CompiledDragTable Cubic = G7.Compile({.Interpolation = Ballistics::DragInterpolation::MonotoneCubic});
+        for (size_t n = 0; n + 1 < G7.Mach.size(); ++n)
+        {
+            assert(std::fabs(Cubic.GetAtMach(G7.Mach[n]) - G7.Cd[n]) <= 1e-6f);
+            const float Low = std::min(G7.Cd[n], G7.Cd[n + 1]);
+            const float High = std::max(G7.Cd[n], G7.Cd[n + 1]);
+            for (float t = 0.1f; t < 1.0f; t += 0.1f)
+            {
+                const float Value = Cubic.GetAtMach(G7.Mach[n] + t * (G7.Mach[n + 1] - G7.Mach[n]));
+                assert(Value >= Low - 1e-6f && Value <= High + 1e-6f);
+            }
+            if (n > 0)
+            {
+                // one sided differences, which differ by the curvature times h, against the jump of the linear slopes
+                constexpr float h = 1e-4f;
+                const float Left = (Cubic.GetAtMach(G7.Mach[n]) - Cubic.GetAtMach(G7.Mach[n] - h)) / h;
+                const float Right = (Cubic.GetAtMach(G7.Mach[n] + h) - Cubic.GetAtMach(G7.Mach[n])) / h;
+                assert(std::fabs(Left - Right) <= 0.01f + 0.1f * std::fabs(Legacy.Slope[n] - Legacy.Slope[n - 1]));
+            }
+        }
+
+        // from files, by extension
+        const std::filesystem::path CsvPath = std::filesystem::temp_directory_path() / "BallisticsTestDragCurve.csv";
+        const std::filesystem::path JsonPath = std::filesystem::temp_directory_path() / "BallisticsTestDragCurve.json";
+        std::ofstream(CsvPath, std::ios::binary) << "Mach,Cd\n0.5,0.25\n1.0,0.4\n2.0,0.3\n";
+        std::ofstream(JsonPath, std::ios::binary) << R"({"mach": [0.5, 1.0, 2.0], "cd": [0.25, 0.4, 0.3]})";
+        assert(Ballistics::LoadDragCurve(CsvPath, Curve) == Ballistics::DragCurveStatus::Ok && Curve.Cd == JsonCurve.Cd);
+        assert(Ballistics::LoadDragCurve(JsonPath, Curve) == Ballistics::DragCurveStatus::Ok && Curve.Mach == JsonCurve.Mach);
+        std::filesystem::remove(CsvPath);
+        std::filesystem::remove(JsonPath);
+        assert(Ballistics::LoadDragCurve(CsvPath, Curve) == Ballistics::DragCurveStatus::CantOpen);
+    }
+
+    void TestDragKernel()
+    {
+        // every table layout: the built-in tables, cubic, clamped, and more knots than grid cells so that lanes miss
+        const Ballistics::DragCurve G7{{Ballistics::CompiledG7.Mach.begin(), Ballistics::CompiledG7.Mach.end()}, {Ballistics::CompiledG7.Cd.begin(), Ballistics::CompiledG7.Cd.end()}};
+        const Ballistics::CompiledDragTable CubicG7 = G7.Compile({.Interpolation = Ballistics::DragInterpolation::MonotoneCubic});
+        const Ballistics::CompiledDragTable LinearG7 = G7.Compile({.Extrapolation = Ballistics::DragExtrapolation::Linear});
+        Ballistics::DragCurve Dense;
+        for (int n = 0; n < 6000; ++n)
+        {
+            // irregular spacing, closer than the grid resolves
+            Dense.Mach.push_back(0.5f + 0.0005f * static_cast<float>(n) + (n % 3 == 0 ? 0.0002f : 0.0f));
+            Dense.Cd.push_back(0.3f + 0.1f * std::sin(static_cast<float>(n) * 0.01f));
+        }
+        assert(Dense.Validate() == Ballistics::DragCurveStatus::Ok);
+        const Ballistics::CompiledDragTable DenseTable = Dense.Compile();
+        // resampled tables take the uniform path
+        const Ballistics::CompiledDragTable UniformG7 = G7.Compile({.NumUniformKnots = 401});
+        const Ballistics::CompiledDragTable UniformCubicG7 = G7.Compile({.Interpolation = Ballistics::DragInterpolation::MonotoneCubic, .NumUniformKnots = 257});
+        assert(UniformG7.UniformStep > 0.0f && UniformCubicG7.UniformStep > 0.0f && Ballistics::CompiledG7.UniformStep == 0.0f);
+
+        // from below Mach 0, under the first knot of every table, to beyond Mach 5, a count that leaves a tail for every lane width
+        std::vector<float> Mach;
+        for (float M = -0.1f; M < 5.5f; M += 0.0007f)
+        {
+            Mach.push_back(M);
+        }
+        // NaN lanes get what the scalar lookup returns for NaN, on every path
+        for (size_t n = 3; n < Mach.size(); n += 997)
+        {
+            Mach[n] = std::numeric_limits<float>::quiet_NaN();
+        }
+        for (const Ballistics::CompiledDragTable* Table : {&Ballistics::CompiledG1, &Ballistics::CompiledG7, &CubicG7, &LinearG7, &DenseTable, &UniformG7, &UniformCubicG7})
+        {
+            for (const Ballistics::SimdLevel Level : {Ballistics::SimdLevel::Scalar, Ballistics::SimdLevel::SSE41, Ballistics::SimdLevel::AVX2})
+            {
+                std::vector<float> Cd(Mach.size());
+                Ballistics::GetDragCoefficientsAtMach(*Table, Mach, Cd, Level);
+                for (size_t n = 0; n < Mach.size(); ++n)
+                {
+                    const float Expected = Table->GetAtMach(Mach[n]);
+                    assert(std::fabs(Cd[n] - Expected) <= 1e-6f * std::max(1.0f, std::fabs(Expected)));
+                }
+            }
+        }
+
+        // from speeds and temperatures, in place
+        std::vector<float> Speeds;
+        std::vector<float> Temperatures;
+        for (float Speed = 0.0f; Speed < 1800.0f; Speed += 0.31f)
+        {
+            Speeds.push_back(Speed);
+            Temperatures.push_back(250.0f + std::fmod(Speed, 70.0f));
+        }
+        Speeds[5] = std::numeric_limits<float>::quiet_NaN();
+        std::vector<float> Cd = Speeds;
+        Ballistics::GetDragCoefficients(Ballistics::CompiledG7, Cd, Temperatures, Cd);
+        for (size_t n = 0; n < Speeds.size(); ++n)
+        {
+            const float Expected = Ballistics::GetDragCoefficient(Ballistics::CompiledG7, Speeds[n], Temperatures[n]);
+            assert(std::fabs(Cd[n] - Expected) <= 1e-6f);
+        }
+    }
+
+    void TestEnvironmentData()
+    {
+        Ballistics::EnvironmentData Environment;
+        Environment.Gravity = -9.81f;
+        Environment.TKelvin = 288.15f;
+        Environment.AirPressure = 101325.0f;
+        Environment.UpdateAirDensityFromTandP();
+        assert(std::fabs(Environment.AirDensity - 1.225f) <= 1e-3f);
+        assert(std::fabs(Environment.GetInvSpeedOfSound() * 340.3f - 1.0f) <= 1e-3f);
+
+        // the Mach scale follows the temperature
+        Environment.TKelvin = 253.15f;
+        Environment.UpdateAirDensityFromTandP();
+        assert(std::fabs(Environment.GetInvSpeedOfSound() * 319.0f - 1.0f) <= 1e-3f);
+
+        for (float Speed = 10.0f; Speed < 2000.0f; Speed += 7.3f)
+        {
+            const float Mach = Speed * Environment.GetInvSpeedOfSound();
+            assert(std::fabs(Ballistics::GetDragCoefficientAtMach(Ballistics::G7, Mach) - Ballistics::GetDragCoefficient(Ballistics::G7, Speed, Environment.TKelvin)) <= 1e-5f);
+            assert(std::fabs(Ballistics::GetDragCoefficientAtMach(Ballistics::CompiledG7, Mach) - Ballistics::GetDragCoefficient(Ballistics::CompiledG7, Speed, Environment.TKelvin)) <= 1e-5f);
+        }
+    }
+
+    void TestBatchSolver()
+    {
+        Ballistics::EnvironmentData Environment;
+        Environment.Gravity = -9.81f;
+        Environment.TKelvin = 292.0f;
+        Environment.AirPressure = 101325.0f;
+        Environment.UpdateAirDensityFromTandP();
+
+        Ballistics::SolverParams Solver;
+        Solver.MaxTime = 10.0f;
+        Solver.TimeStep = 0.01f;
+        Solver.MaxX = 300.0f;
+
+        // muzzle velocity spread, the slowest lanes finish first
+        std::vector<Ballistics::FiringData> Lanes(8);
+        for (size_t n = 0; n < Lanes.size(); ++n)
+        {
+            Lanes[n].Bullet.MassGr = 155.0f;
+            Lanes[n].Bullet.CallibreMm = Ballistics::Callibre308Mm;
+            Lanes[n].Height = 1.0f;
+            Lanes[n].ZeroAngle = 0.001f;
+            Lanes[n].MuzzleVelocityMs = 600.0f + 40.0f * static_cast<float>(n);
+        }
+
+        std::vector<std::vector<Ballistics::TrajectoryDataPoint>> BatchTrajectories(Lanes.size());
+        Ballistics::SolveTrajectoryBatch(Ballistics::CompiledG7, BatchTrajectories, Lanes, std::span(&Environment, 1), Solver);
+
+        for (size_t n = 0; n < Lanes.size(); ++n)
+        {
+            std::vector<Ballistics::TrajectoryDataPoint> Trajectory;
+            Ballistics::SolveTrajectory(Ballistics::CompiledG7, Trajectory, Lanes[n], Environment, Solver);
+            assert(Trajectory.size() == BatchTrajectories[n].size());
+            for (size_t nQ = 0; nQ < Trajectory.size(); ++nQ)
+            {
+                assert(std::fabs(Trajectory[nQ].Position.GetX() - BatchTrajectories[n][nQ].Position.GetX()) < 1e-2f);
+                assert(std::fabs(Trajectory[nQ].Position.GetY() - BatchTrajectories[n][nQ].Position.GetY()) < 1e-3f);
+            }
+        }
+    }
+
+    void TestRangeCards()
+    {
+        Ballistics::EnvironmentData Environments[2];
+        for (Ballistics::EnvironmentData& Environment : Environments)
+        {
+            Environment.Gravity = -9.81f;
+            Environment.AirPressure = 101325.0f;
+        }
+        Environments[0].TKelvin = 262.0f;
+        Environments[1].TKelvin = 302.0f;
+        for (Ballistics::EnvironmentData& Environment : Environments)
+        {
+            Environment.UpdateAirDensityFromTandP();
+        }
+
+        Ballistics::RangeCardLoad Loads[3];
+        for (size_t n = 0; n < std::size(Loads); ++n)
+        {
+            Loads[n].Firing.Bullet.MassGr = 150.0f + 10.0f * static_cast<float>(n);
+            Loads[n].Firing.Bullet.CallibreMm = Ballistics::Callibre308Mm;
+            Loads[n].Firing.Height = 1.0f;
+            Loads[n].Firing.ZeroDistance = 200.0f;
+            Loads[n].Firing.MuzzleVelocityMs = 850.0f;
+            Loads[n].DragTable = (n & 1) ? &Ballistics::CompiledG1 : &Ballistics::CompiledG7;
+        }
+
+        Ballistics::RangeCardParams Params;
+        Params.DistanceStep = 25.0f;
+        Params.MaxDistance = 800.0f;
+
+        Ballistics::WorkStealingPool Pool(4);
+        Ballistics::RangeCards Cards;
+        Ballistics::GenerateRangeCards(Pool, Cards, Loads, Environments, Params);
+        assert(Cards.GetNumRows() == 32);
+
+        // the same pool shared by two threads, their calls don't mix up each other's tasks
+        {
+            Ballistics::RangeCards SharedCards[2];
+            std::thread Other([&]() { Ballistics::GenerateRangeCards(Pool, SharedCards[1], Loads, Environments, Params); });
+            Ballistics::GenerateRangeCards(Pool, SharedCards[0], Loads, Environments, Params);
+            Other.join();
+            for (const Ballistics::RangeCards& Shared : SharedCards)
+            {
+                for (size_t nCard = 0; nCard < std::size(Loads) * std::size(Environments); ++nCard)
+                {
+                    const auto Card = Shared.GetCard(nCard / std::size(Environments), nCard % std::size(Environments));
+                    const auto Expected = Cards.GetCard(nCard / std::size(Environments), nCard % std::size(Environments));
+                    assert(Card.back().bValid && Card.back().DropM == Expected.back().DropM);
+                }
+            }
+        }
+
+        // a step that isn't representable keeps the last row
+        Ballistics::RangeCardParams FineParams;
+        FineParams.DistanceStep = 0.3f;
+        FineParams.MaxDistance = 9.0f;
+        assert(Ballistics::RangeCards(1, 1, FineParams).GetNumRows() == 30);
+
+        for (size_t nLoad = 0; nLoad < std::size(Loads); ++nLoad)
+        {
+            for (size_t nEnvironment = 0; nEnvironment < std::size(Environments); ++nEnvironment)
+            {
+                // identical to generating the card on this thread
+                std::vector<Ballistics::RangeCardRow> Expected(Cards.GetNumRows());
+                Ballistics::GenerateRangeCard(Expected, Loads[nLoad], Environments[nEnvironment], Params);
+
+                const std::span<const Ballistics::RangeCardRow> Card = Cards.GetCard(nLoad, nEnvironment);
+                for (size_t nRow = 0; nRow < Card.size(); ++nRow)
+                {
+                    assert(Card[nRow].bValid);
+                    assert(Card[nRow].DropM == Expected[nRow].DropM);
+                    assert(Card[nRow].TimeOfFlightS == Expected[nRow].TimeOfFlightS);
+                    assert(nRow == 0 || Card[nRow].VelocityMs < Card[nRow - 1].VelocityMs);
+                }
+                // zeroed at 200m, falling below the line of sight beyond it
+                assert(std::fabs(Card[7].DropM) < 0.05f);
+                assert(Card[31].DropM < Card[15].DropM);
+                assert(Card[31].DriftM == 0.0f);
+            }
+        }
+
+        // wind from the left with the 3D solver drifts right, increasingly with distance
+        Environments[0].WindMs = {0.0f, 0.0f, 5.0f};
+        Params.Integrator = Ballistics::IntegratorType::PointMass3D;
+        std::vector<Ballistics::RangeCardRow> WindCard(Cards.GetNumRows());
+        Ballistics::GenerateRangeCard(WindCard, Loads[0], Environments[0], Params);
+        assert(WindCard[31].bValid && WindCard[31].DriftM > WindCard[15].DriftM && WindCard[15].DriftM > 0.0f);
+        assert(std::fabs(WindCard[7].DropM) < 0.05f);
+
+        // a zero distance out of reach leaves every row invalid rather than filled from the last trial angle
+        Ballistics::RangeCardLoad Unreachable = Loads[0];
+        Unreachable.Firing.ZeroDistance = 20000.0f;
+        std::vector<Ballistics::RangeCardRow> UnreachableCard(Cards.GetNumRows());
+        Ballistics::GenerateRangeCard(UnreachableCard, Unreachable, Environments[1], Params);
+        for (size_t nRow = 0; nRow < UnreachableCard.size(); ++nRow)
+        {
+            assert(!UnreachableCard[nRow].bValid && UnreachableCard[nRow].Distance == Params.DistanceStep * static_cast<float>(nRow + 1));
+        }
+    }
+
+    void TestDispersion()
+    {
+        // Philox4x32-10 known answer, Random123 test vector for a zero key and counter
+        constexpr Ballistics::CounterRandom::BlockType Expected{0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u};
+        static_assert(Ballistics::CounterRandom::Philox({0, 0, 0, 0}, {0, 0}) == Expected);
+
+        // a stream only depends on its seed and index
+        Ballistics::CounterRandom Random(42, 7);
+        Ballistics::CounterRandom SameRandom(42, 7);
+        Ballistics::CounterRandom OtherRandom(42, 8);
+        double Sum = 0.0;
+        double SumSq = 0.0;
+        constexpr int NumDraws = 10000;
+        for (int n = 0; n < NumDraws; ++n)
+        {
+            const float Gaussian = Random.NextGaussian();
+            assert(Gaussian == SameRandom.NextGaussian());
+            assert(Gaussian != OtherRandom.NextGaussian());
+            Sum += Gaussian;
+            SumSq += static_cast<double>(Gaussian) * Gaussian;
+        }
+        assert(std::fabs(Sum / NumDraws) < 0.05);
+        assert(std::fabs(SumSq / NumDraws - 1.0) < 0.05);
+
+        Ballistics::EnvironmentData Environment;
+        Environment.Gravity = -9.81f;
+        Environment.TKelvin = 292.0f;
+        Environment.AirPressure = 101325.0f;
+        Environment.UpdateAirDensityFromTandP();
+
+        Ballistics::FiringData FiringData;
+        FiringData.Bullet.MassGr = 155.0f;
+        FiringData.Bullet.CallibreMm = Ballistics::Callibre308Mm;
+        FiringData.Height = 1.0f;
+        FiringData.ZeroDistance = 300.0f;
+        FiringData.MuzzleVelocityMs = 871.42f;
+        Ballistics::ZeroingParams Zeroing;
+        Zeroing.TimeStep = 0.002f;
+        FiringData.ZeroIn(Ballistics::CompiledG7, 0.001f, Environment, Zeroing);
+
+        Ballistics::DispersionParams Params;
+        Params.NumSamples = 500;
+        Params.Seed = 1234;
+        Params.BatchSize = 16;
+        Params.DistanceM = 300.0f;
+        Params.TimeStep = 0.002f;
+        Params.Integrator = Ballistics::IntegratorType::HybridEulerRk4;
+
+        Ballistics::DispersionTarget Target;
+        Target.WidthM = Target.HeightM = 0.1f;
+
+        // without any variation every sample hits the zero
+        Ballistics::WorkStealingPool SingleThread(1);
+        Ballistics::DispersionResult Result = Ballistics::SimulateDispersion(SingleThread, Ballistics::CompiledG7, FiringData, Environment, Params, Target);
+        assert(Result.NumValid == Params.NumSamples && Result.NumHits == Params.NumSamples);
+        assert(Result.HitProbability == 1.0f && Result.HitProbabilityStdError == 0.0f);
+        assert(std::fabs(Result.MeanYM) < 0.002f && Result.SdYM < 1e-4f && Result.MeanRadiusM < 1e-4f);
+
+        // identical results on any number of threads, with wind drift from the 3D solver
+        Params.Integrator = Ballistics::IntegratorType::PointMass3D;
+        Params.MuzzleVelocitySdMs = 10.0f;
+        Params.BallisticCoefficientSd = 0.02f;
+        Params.CrossWindSdMs = 2.0f;
+        Params.AimSdRad = 0.0002f;
+        Params.bKeepImpacts = true;
+        Result = Ballistics::SimulateDispersion(SingleThread, Ballistics::CompiledG7, FiringData, Environment, Params, Target);
+        Ballistics::WorkStealingPool Pool(4);
+        const Ballistics::DispersionResult ParallelResult = Ballistics::SimulateDispersion(Pool, Ballistics::CompiledG7, FiringData, Environment, Params, Target);
+        assert(ParallelResult.NumHits == Result.NumHits);
+        assert(ParallelResult.MeanYM == Result.MeanYM && ParallelResult.MeanZM == Result.MeanZM);
+        assert(ParallelResult.SdYM == Result.SdYM && ParallelResult.SdZM == Result.SdZM);
+        assert(ParallelResult.MeanRadiusM == Result.MeanRadiusM);
+        assert(Result.Impacts.size() == Params.NumSamples);
+        for (size_t n = 0; n < Result.Impacts.size(); ++n)
+        {
+            assert(ParallelResult.Impacts[n].YM == Result.Impacts[n].YM);
+            assert(ParallelResult.Impacts[n].ZM == Result.Impacts[n].ZM);
+        }
+        // a sample on its own is the same as in the simulation
+        const Ballistics::DispersionImpact Impact = Ballistics::SolveDispersionSample(Ballistics::CompiledG7, FiringData, Environment, Params, Target, 123);
+        assert(Impact.YM == Result.Impacts[123].YM && Impact.bHit == Result.Impacts[123].bHit);
+
+        // the group is centred on the zero, wider across (wind) than up (velocity) and misses a small target sometimes
+        assert(std::fabs(Result.MeanYM) < 0.01f && std::fabs(Result.MeanZM) < 0.02f);
+        assert(Result.SdZM > Result.SdYM && Result.SdYM > 0.01f);
+        assert(Result.HitProbability > 0.1f && Result.HitProbability < 0.9f);
+        assert(Result.HitProbabilityStdError > 0.0f && Result.HitProbabilityStdError < 0.03f);
+
+        // and always hits a large one
+        Target.Shape = Ballistics::TargetShape::Rectangle;
+        Target.WidthM = Target.HeightM = 2.0f;
+        Result = Ballistics::SimulateDispersion(Pool, Ballistics::CompiledG7, FiringData, Environment, Params, Target);
+        assert(Result.HitProbability == 1.0f);
+
+        // holding 10mrad high moves the group up by ~3m at 300m
+        Params.HoldElevationRad = 0.01f;
+        Result = Ballistics::SimulateDispersion(Pool, Ballistics::CompiledG7, FiringData, Environment, Params, Target);
+        assert(std::fabs(Result.MeanYM - 3.0f) < 0.1f);
+        assert(Result.HitProbability < 0.01f);
+    }
+
+    void TestRungeKutta4()
+    {
+        // dY/dt = -Y on a vector state, Y(1) = Y0/e
+        struct Decay
+        {
+            Algebra::Vector2D operator()(const Algebra::Vector2D& Y, float /* t */) const
+            {
+                return -Y;
+            }
+        };
+        Solver::TRungeKutta4<Algebra::Vector2D, Decay> Integrator;
+        Integrator.Initialize({1.0f, 2.0f}, 0.01f, Decay{});
+        for (int n = 0; n < 100; ++n)
+        {
+            Integrator.Advance();
+        }
+        const float InvE = 1.0f / static_cast<float>(std::numbers::e);
+        assert(std::fabs(Integrator.Y.GetX() - InvE) < 1e-5f);
+        assert(std::fabs(Integrator.Y.GetY() - 2.0f * InvE) < 1e-5f);
+
+        // the type erased form integrates identically
+        Solver::RungeKutta4 TypeErased;
+        TypeErased.Initialize(1.0f, 0.01f, [](float Y, float /* t */) { return -Y; });
+        for (int n = 0; n < 100; ++n)
+        {
+            TypeErased.Advance();
+        }
+        assert(TypeErased.Y == Integrator.Y.GetX());
+    }
+
+    void TestAdaptiveSolver()
+    {
+        Ballistics::EnvironmentData Environment;
+        Environment.Gravity = -9.81f;
+        Environment.TKelvin = 292.0f;
+        Environment.AirPressure = 101325.0f;
+        Environment.UpdateAirDensityFromTandP();
+
+        Ballistics::FiringData FiringData;
+        FiringData.Bullet.MassGr = 155.0f;
+        FiringData.Bullet.CallibreMm = Ballistics::Callibre308Mm;
+        FiringData.Height = 1.0f;
+        FiringData.ZeroAngle = 0.002f;
+        FiringData.MuzzleVelocityMs = 871.42f;
+
+        Ballistics::SolverParams Solver;
+        Solver.Integrator = Ballistics::IntegratorType::DormandPrince45;
+        Solver.MaxTime = 10.0f;
+        Solver.MaxX = 1000.0f;
+        Solver.MinY = -100.0f;
+        Solver.TimeStep = 0.001f;
+
+        // reference, fixed 1ms steps
+        Ballistics::SolverParams FixedSolver = Solver;
+        FixedSolver.MinTimeStep = FixedSolver.MaxTimeStep = 0.001f;
+        std::vector<Ballistics::TrajectoryDataPoint> FixedSteps;
+        Ballistics::SolveTrajectory(Ballistics::CompiledG7, FixedSteps, FiringData, Environment, FixedSolver);
+
+        std::vector<Ballistics::TrajectoryDataPoint> AdaptiveSteps;
+        Ballistics::SolveTrajectory(Ballistics::CompiledG7, AdaptiveSteps, FiringData, Environment, Solver);
+        assert(AdaptiveSteps.size() * 10 < FixedSteps.size());
+
+        // dense output every 100m
+        FixedSolver.OutputDistanceStep = Solver.OutputDistanceStep = 100.0f;
+        std::vector<Ballistics::TrajectoryDataPoint> Fixed;
+        Ballistics::SolveTrajectory(Ballistics::CompiledG7, Fixed, FiringData, Environment, FixedSolver);
+        std::vector<Ballistics::TrajectoryDataPoint> Adaptive;
+        Ballistics::SolveTrajectory(Ballistics::CompiledG7, Adaptive, FiringData, Environment, Solver);
+        assert(Adaptive.size() == 10 && Fixed.size() == 10);
+        for (size_t n = 0; n < Adaptive.size(); ++n)
+        {
+            assert(std::fabs(Adaptive[n].Position.GetX() - 100.0f * static_cast<float>(n + 1)) < 1e-2f);
+            assert(std::fabs(Adaptive[n].Position.GetY() - Fixed[n].Position.GetY()) < 1e-3f);
+            assert(std::fabs(Adaptive[n].T - Fixed[n].T) < 1e-4f);
+        }
+
+        // long steps end far past MaxX and the ground, the dense output stops at either as the fixed step output does
+        for (const Ballistics::IntegratorType Integrator : {Ballistics::IntegratorType::DormandPrince45, Ballistics::IntegratorType::HybridEulerRk4})
+        {
+            Ballistics::SolverParams Limited = Solver;
+            Limited.Integrator = Integrator;
+            Limited.MaxTimeStep = 0.5f;
+            Limited.Tolerance = 1e-3f;
+            Limited.MaxX = 950.0f;
+            std::vector<Ballistics::TrajectoryDataPoint> ToMaxX;
+            Ballistics::SolveTrajectory(Ballistics::CompiledG7, ToMaxX, FiringData, Environment, Limited);
+            assert(ToMaxX.size() == 9);
+
+            Limited.MaxX = 0.0f;
+            Limited.MinY = 0.0f;
+            Limited.OutputDistanceStep = 10.0f;
+            std::vector<Ballistics::TrajectoryDataPoint> ToGround;
+            Ballistics::SolveTrajectory(Ballistics::CompiledG7, ToGround, FiringData, Environment, Limited);
+            assert(!ToGround.empty());
+            for (const Ballistics::TrajectoryDataPoint& Point : ToGround)
+            {
+                assert(Point.Position.GetY() >= 0.0f);
+            }
+        }
+    }
+
+    void TestPointMass3D()
+    {
+        Ballistics::EnvironmentData Environment;
+        Environment.Gravity = -9.81f;
+        Environment.TKelvin = 292.0f;
+        Environment.AirPressure = 101325.0f;
+        Environment.UpdateAirDensityFromTandP();
+
+        Ballistics::FiringData FiringData;
+        FiringData.Bullet.MassGr = 155.0f;
+        FiringData.Bullet.CallibreMm = Ballistics::Callibre308Mm;
+        FiringData.ZeroAngle = 0.005f;
+        FiringData.MuzzleVelocityMs = 871.42f;
+
+        Ballistics::SolverParams Solver;
+        Solver.MaxTime = 10.0f;
+        Solver.MaxX = 1000.0f;
+        Solver.MinY = -100.0f;
+        Solver.TimeStep = 0.001f;
+        Solver.OutputDistanceStep = 1000.0f;
+
+        const auto SolveAt1000 = [&](const Ballistics::EnvironmentData& InEnvironment, const Ballistics::FiringData& InFiringData, const Ballistics::SolverParams& InSolver)
+            {
+                std::vector<Ballistics::TrajectoryDataPoint> Points;
+                Ballistics::SolveTrajectory(Ballistics::CompiledG7, Points, InFiringData, InEnvironment, InSolver);
+                assert(Points.size() == 1);
+                return Points.back();
+            };
+
+        // without wind, Coriolis and spin it is the 2D point mass model
+        Solver.Integrator = Ballistics::IntegratorType::DormandPrince45;
+        const Ballistics::TrajectoryDataPoint PointMass2D = SolveAt1000(Environment, FiringData, Solver);
+        Solver.Integrator = Ballistics::IntegratorType::PointMass3D;
+        const Ballistics::TrajectoryDataPoint Still = SolveAt1000(Environment, FiringData, Solver);
+        assert(std::fabs(Still.Position.GetY() - PointMass2D.Position.GetY()) <= 0.01f);
+        assert(std::fabs(Still.T - PointMass2D.T) <= 1e-3f);
+        assert(Still.Drift == 0.0f);
+
+        // 10mph full value wind from the left; the classic lag time estimate W (TOF - X / V0)
+        Ballistics::EnvironmentData Windy = Environment;
+        Windy.WindMs = {0.0f, 0.0f, 4.4704f};
+        const Ballistics::TrajectoryDataPoint WindDrift = SolveAt1000(Windy, FiringData, Solver);
+        const float LagTimeDrift = 4.4704f * (WindDrift.T - 1000.0f / FiringData.MuzzleVelocityMs);
+        assert(WindDrift.Drift > 0.0f && std::fabs(WindDrift.Drift - LagTimeDrift) <= 0.05f * LagTimeDrift);
+
+        // northern hemisphere deflects to the right; in vacuum by exactly omega X sin(latitude) TOF
+        Ballistics::SolverParams Coriolis = Solver;
+        Coriolis.bCoriolis = true;
+        Ballistics::EnvironmentData North = Environment;
+        North.LatitudeRad = 60.0f * static_cast<float>(std::numbers::pi) / 180.0f;
+        const Ballistics::TrajectoryDataPoint CoriolisNorth = SolveAt1000(North, FiringData, Coriolis);
+        assert(CoriolisNorth.Drift > 0.0f);
+        Ballistics::EnvironmentData Vacuum = North;
+        Vacuum.AirDensity = 0.0f;
+        const Ballistics::TrajectoryDataPoint CoriolisVacuum = SolveAt1000(Vacuum, FiringData, Coriolis);
+        const float HorizontalCoriolis = 7.292115e-5f * 1000.0f * std::sin(North.LatitudeRad) * CoriolisVacuum.T;
+        assert(std::fabs(CoriolisVacuum.Drift - HorizontalCoriolis) <= 0.01f * HorizontalCoriolis);
+        // and eastward shots go high
+        Ballistics::FiringData East = FiringData;
+        East.AzimuthRad = 0.5f * static_cast<float>(std::numbers::pi);
+        assert(SolveAt1000(North, East, Coriolis).Position.GetY() > Still.Position.GetY());
+
+        // empirical spin drift, to the right for right hand twist
+        Ballistics::FiringData Spinning = FiringData;
+        Spinning.SpinStability = 1.5f;
+        const Ballistics::TrajectoryDataPoint SpinDrift = SolveAt1000(Environment, Spinning, Solver);
+        assert(std::fabs(SpinDrift.Drift - 0.0254f * 1.25f * 2.7f * std::pow(SpinDrift.T, 1.83f)) <= 0.005f);
+        Spinning.bLeftHandTwist = true;
+        assert(std::fabs(SolveAt1000(Environment, Spinning, Solver).Drift + SpinDrift.Drift) <= 1e-4f);
+    }
+
+    void TestTrajectoryOutput()
+    {
+        Ballistics::EnvironmentData Environment;
+        Environment.Gravity = -9.81f;
+        Environment.TKelvin = 292.0f;
+        Environment.AirPressure = 101325.0f;
+        Environment.UpdateAirDensityFromTandP();
+
+        Ballistics::FiringData FiringData;
+        FiringData.Bullet.MassGr = 155.0f;
+        FiringData.Bullet.G7BC = 0.275f;
+        FiringData.Bullet.CallibreMm = Ballistics::Callibre308Mm;
+        FiringData.Height = 1.0f;
+        FiringData.ZeroAngle = 0.002f;
+        FiringData.MuzzleVelocityMs = 871.42f;
+
+        Ballistics::SolverParams Solver;
+        Solver.MaxTime = 10.0f;
+        Solver.TimeStep = 0.01f;
+        Solver.MaxX = 500.0f;
+        Solver.MinY = -100.0f;
+
+        std::vector<Ballistics::TrajectoryDataPoint> Reference;
+        Ballistics::SolveTrajectory(Ballistics::CompiledG7, Reference, FiringData, Environment, Solver);
+        assert(Reference.size() > 10);
+
+        // into a buffer; the whole trajectory, or as much as fits
+        std::vector<Ballistics::TrajectoryDataPoint> Buffer(Reference.size() + 10);
+        size_t NumPoints = Ballistics::SolveTrajectory(Ballistics::CompiledG7, std::span(Buffer), FiringData, Environment, Solver);
+        assert(NumPoints == Reference.size());
+        for (size_t n = 0; n < NumPoints; ++n)
+        {
+            assert(Buffer[n].Position == Reference[n].Position && Buffer[n].T == Reference[n].T);
+        }
+        NumPoints = Ballistics::SolveTrajectory(Ballistics::CompiledG7, std::span(Buffer).first(10), FiringData, Environment, Solver);
+        assert(NumPoints == 10 && Buffer[9].T == Reference[9].T);
+
+        // streamed, stopping early
+        size_t NumSunk = 0;
+        Ballistics::SolveTrajectory(Ballistics::CompiledG7, [&NumSunk](const Ballistics::TrajectoryDataPoint& Point)
+            {
+                ++NumSunk;
+                return Point.Position.GetX() < 100.0f;
+            }, FiringData, Environment, Solver);
+        assert(NumSunk > 1 && NumSunk < Reference.size() && Reference[NumSunk - 1].Position.GetX() >= 100.0f);
+
+        // every 3rd step
+        Ballistics::SolverParams Decimated = Solver;
+        Decimated.OutputStepStride = 3;
+        std::vector<Ballistics::TrajectoryDataPoint> Strided;
+        Ballistics::SolveTrajectory(Ballistics::CompiledG7, Strided, FiringData, Environment, Decimated);
+        assert(Strided.size() == Reference.size() / 3);
+        assert(Strided[1].T == Reference[5].T);
+
+        // every 50m, interpolated within the fixed steps
+        Decimated = Solver;
+        Decimated.OutputDistanceStep = 50.0f;
+        std::vector<Ballistics::TrajectoryDataPoint> EveryFiftyMetres;
+        Ballistics::SolveTrajectory(Ballistics::CompiledG7, EveryFiftyMetres, FiringData, Environment, Decimated);
+        assert(EveryFiftyMetres.size() == 10);
+        for (size_t n = 0; n < EveryFiftyMetres.size(); ++n)
+        {
+            assert(std::fabs(EveryFiftyMetres[n].Position.GetX() - 50.0f * static_cast<float>(n + 1)) <= 1e-3f);
+        }
+    }
+
+    void TestTrajectoryTable()
+    {
+        Ballistics::EnvironmentData Environment;
+        Environment.Gravity = -9.81f;
+        Environment.TKelvin = 292.0f;
+        Environment.AirPressure = 101325.0f;
+        Environment.UpdateAirDensityFromTandP();
+
+        Ballistics::FiringData FiringData;
+        FiringData.Bullet.MassGr = 155.0f;
+        FiringData.Bullet.CallibreMm = Ballistics::Callibre308Mm;
+        FiringData.Height = 1.0f;
+        FiringData.ZeroAngle = 0.002f;
+        FiringData.MuzzleVelocityMs = 871.42f;
+
+        Ballistics::SolverParams Solver;
+        Solver.MaxTime = 10.0f;
+        Solver.TimeStep = 0.01f;
+        Solver.MaxX = 800.0f;
+
+        // fixed step, queries by time are O(1) and reproduce the solver's points
+        std::vector<Ballistics::TrajectoryDataPoint> Points;
+        Ballistics::SolveTrajectory(Ballistics::CompiledG7, Points, FiringData, Environment, Solver);
+        Ballistics::TrajectoryTable Table;
+        Ballistics::SolveTrajectory(Ballistics::CompiledG7, Table, FiringData, Environment, Solver);
+        assert(Table.Size() == Points.size() + 1);
+        for (const Ballistics::TrajectoryDataPoint& Point : Points)
+        {
+            const std::optional<Ballistics::TrajectorySample> Sample = Table.AtT(Point.T);
+            assert(Sample.has_value());
+            assert(std::fabs(Sample->Point.Position.GetY() - Point.Position.GetY()) < 1e-4f);
+            assert(std::fabs(Sample->Point.Velocity.GetX() - Point.Velocity.GetX()) < 1e-1f);
+
+            const std::optional<Ballistics::TrajectorySample> SampleAtX = Table.AtX(Point.Position.GetX());
+            assert(std::fabs(SampleAtX->Point.T - Point.T) < 1e-4f);
+        }
+        assert(!Table.AtX(-1.0f).has_value());
+        assert(!Table.AtT(Table.GetMaxT() + 1.0f).has_value());
+
+        // adaptive steps are sparse, the interpolant still matches the integrator's own dense output
+        Solver.Integrator = Ballistics::IntegratorType::DormandPrince45;
+        Ballistics::SolveTrajectory(Ballistics::CompiledG7, Table, FiringData, Environment, Solver);
+        Solver.OutputDistanceStep = 437.0f;
+        Points.clear();
+        Ballistics::SolveTrajectory(Ballistics::CompiledG7, Points, FiringData, Environment, Solver);
+        const std::optional<Ballistics::TrajectorySample> At437 = Table.AtX(437.0f);
+        assert(At437.has_value() && Points.size() == 1);
+        assert(std::fabs(At437->Point.Position.GetX() - 437.0f) < 1e-2f);
+        assert(std::fabs(At437->Point.Position.GetY() - Points[0].Position.GetY()) < 5e-3f);
+        assert(std::fabs(At437->Point.T - Points[0].T) < 1e-3f);
+        assert(At437->EnergyJ > 0.0f);
     }
 
     void TestAlgebra()
@@ -136,14 +1265,173 @@ namespace
         const Algebra::Vector2D ProjectedNormalY = RotatedUnitVectorY.ProjectedNormalRH();
         assert(ProjectedNormalX.Dot(RotatedUnitVectorX) == 0.0f);
         assert(ProjectedNormalY.Dot(RotatedUnitVectorY) == 0.0f);
+
+        constexpr Algebra::Vector3D UnitX(1.0f, 0.0f, 0.0f);
+        constexpr Algebra::Vector3D UnitY(0.0f, 1.0f, 0.0f);
+        static_assert(UnitX.Cross(UnitY) == Algebra::Vector3D(0.0f, 0.0f, 1.0f));
+        static_assert(UnitX.Dot(UnitY) == 0.0f);
+        Algebra::Vector3D Diagonal(1.0f, 1.0f, 1.0f);
+        assert(MathLib::NearlyEqual(Diagonal.Normalize().LengthSq(), 1.0f));
+    }
+
+    // keeps the lines a frame draws, counting the batches that submit them
+    struct RecordingRenderer : Plotter::IRenderer
+    {
+        std::vector<std::array<float, 4>> Lines;
+        size_t NumBatches = 0;
+
+        void DrawLine(float x0, float y0, float x1, float y1, Plotter::ColorRGB) override
+        {
+            Lines.push_back({x0, y0, x1, y1});
+        }
+        void DrawLines(std::span<const Plotter::Line2D> InLines, Plotter::ColorRGB Color) override
+        {
+            ++NumBatches;
+            IRenderer::DrawLines(InLines, Color);
+        }
+        void DrawPolyline(std::span<const Algebra::Vector2D> Points, Plotter::ColorRGB Color) override
+        {
+            ++NumBatches;
+            IRenderer::DrawPolyline(Points, Color);
+        }
+        void FillCircles(std::span<const Algebra::Vector2D> Centers, float Radius, Plotter::ColorRGB Color) override
+        {
+            ++NumBatches;
+            IRenderer::FillCircles(Centers, Radius, Color);
+        }
+        void DrawText(const std::string&, const Algebra::Vector2D&, Plotter::ColorRGB) override {}
+        Plotter::Range2D GetViewportExtents() override
+        {
+            return {{0.0f, 0.0f}, {800.0f, 600.0f}};
+        }
+    };
+
+    void TestPlotter()
+    {
+        const auto Renderer = std::make_shared<RecordingRenderer>();
+        Plotter::SetRenderer(Renderer);
+        const auto MakePlot = []()
+            {
+                Plotter::Curve2D Curve;
+                for (int n = 0; n < 20; ++n)
+                {
+                    Curve.AddPoint(static_cast<float>(n), std::sin(static_cast<float>(n) * 0.4f));
+                }
+                Plotter::PlotPtr Plot = Plotter::Plot::Create();
+                Plot->AddCurve(std::move(Curve));
+                Plot->AddLine({0.0f, 0.0f}, {19.0f, 0.0f}, Plotter::Gray);
+                Plot->AddLine({0.0f, -1.0f}, {0.0f, 1.0f}, Plotter::Gray);
+                return Plot;
+            };
+        const auto RenderLines = [&Renderer](const Plotter::PlotPtr& Plot, const Plotter::Range2D& Window)
+            {
+                Renderer->Lines.clear();
+                Renderer->NumBatches = 0;
+                Plotter::BeginFrame();
+                Plotter::DrawPlot(Plot, Window);
+                Plotter::RenderFrame();
+                Plotter::EndFrame();
+                return Renderer->Lines;
+            };
+
+        // the second frame draws the cached tessellation
+        const Plotter::Range2D Window = {{80.0f, 90.0f}, {720.0f, 510.0f}};
+        const Plotter::PlotPtr Plot = MakePlot();
+        const std::vector<std::array<float, 4>> First = RenderLines(Plot, Window);
+        assert(First.size() > 20);
+        assert(RenderLines(Plot, Window) == First);
+        // the curve, its markers and both axes of one color
+        assert(Renderer->NumBatches == 3);
+
+        // resizing tessellates again, as a plot drawn at that size for the first time would
+        const Plotter::Range2D Resized = {{40.0f, 50.0f}, {760.0f, 550.0f}};
+        const std::vector<std::array<float, 4>> ResizedLines = RenderLines(Plot, Resized);
+        assert(ResizedLines != First);
+        assert(ResizedLines == RenderLines(MakePlot(), Resized));
+        assert(RenderLines(Plot, Window) == First);
+
+        Plotter::SetRenderer(nullptr);
+    }
+
+    void TestCurveFindNearest()
+    {
+        // a trajectory in x order and a spiral that isn't, each point tagged with its index
+        Plotter::Curve2D Trajectory;
+        Plotter::Curve2D Spiral;
+        std::vector<Algebra::Vector2D> TrajectoryPoints;
+        std::vector<Algebra::Vector2D> SpiralPoints;
+        for (int n = 0; n < 5000; ++n)
+        {
+            const float T = static_cast<float>(n) * 0.01f;
+            TrajectoryPoints.emplace_back(T * 80.0f, 1.5f + T * (0.4f - 0.5f * T));
+            Trajectory.AddPoint(TrajectoryPoints.back().GetX(), TrajectoryPoints.back().GetY(), n);
+            SpiralPoints.emplace_back(T * std::cos(T * 3.0f), T * std::sin(T * 3.0f));
+            Spiral.AddPoint(SpiralPoints.back().GetX(), SpiralPoints.back().GetY(), n);
+        }
+
+        // the same point and distance as scanning them all, the first of equally near points
+        const auto CheckNearest = [](const Plotter::Curve2D& Curve, const std::vector<Algebra::Vector2D>& Points, const Algebra::Vector2D& Query)
+            {
+                float MinDistanceSq = std::numeric_limits<float>::max();
+                size_t MinIndex = 0;
+                for (size_t n = 0; n < Points.size(); ++n)
+                {
+                    if ((Query - Points[n]).LengthSq() < MinDistanceSq)
+                    {
+                        MinDistanceSq = (Query - Points[n]).LengthSq();
+                        MinIndex = n;
+                    }
+                }
+                const auto [Found, DistanceSq] = Curve.FindNearest(Query);
+                assert(Found->MetaDataTag == MinIndex && DistanceSq == MinDistanceSq);
+            };
+        std::mt19937 Generator(7);
+        std::uniform_real_distribution<float> Unit(0.0f, 1.0f);
+        for (int n = 0; n < 500; ++n)
+        {
+            CheckNearest(Trajectory, TrajectoryPoints, {Unit(Generator) * 4200.0f - 100.0f, Unit(Generator) * 20.0f - 15.0f});
+            CheckNearest(Spiral, SpiralPoints, {Unit(Generator) * 120.0f - 60.0f, Unit(Generator) * 120.0f - 60.0f});
+        }
+        // on a point, and a point repeated
+        CheckNearest(Trajectory, TrajectoryPoints, TrajectoryPoints[1234]);
+        Spiral.AddPoint(SpiralPoints[10].GetX(), SpiralPoints[10].GetY(), SpiralPoints.size());
+        SpiralPoints.push_back(SpiralPoints[10]);
+        CheckNearest(Spiral, SpiralPoints, SpiralPoints[10]);
+
+        // added points are found, whether or not they keep the x order
+        Trajectory.AddPoint(4100.0f, -3.0f, TrajectoryPoints.size());
+        TrajectoryPoints.emplace_back(4100.0f, -3.0f);
+        CheckNearest(Trajectory, TrajectoryPoints, {4090.0f, -3.0f});
+        Trajectory.AddPoint(100.0f, -40.0f, TrajectoryPoints.size());
+        TrajectoryPoints.emplace_back(100.0f, -40.0f);
+        CheckNearest(Trajectory, TrajectoryPoints, {101.0f, -39.0f});
+        CheckNearest(Trajectory, TrajectoryPoints, {2000.0f, 0.0f});
     }
 }
 
 int main(int argc, char* argv[])
 {
     TestBulletData();
+    TestBulletCatalogue();
+    TestSnapshot();
     TestCatmullRom();
     TestZero();
+    TestZeroingMethods();
+    TestZeroCache();
+    TestCompiledDragTable();
+    TestDragCurve();
+    TestDragKernel();
+    TestEnvironmentData();
+    TestBatchSolver();
+    TestRangeCards();
+    TestDispersion();
+    TestRungeKutta4();
+    TestAdaptiveSolver();
+    TestPointMass3D();
+    TestTrajectoryOutput();
+    TestTrajectoryTable();
     TestAlgebra();
+    TestPlotter();
+    TestCurveFindNearest();
     return 0;
 }
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <span>
 #include "Algebra.h"
 #include "Curves.h"
 
@@ -89,6 +90,8 @@ namespace Plotter
         {
             return Point.GetX() >= Min.GetX() && Point.GetY() >= Min.GetY() && Point.GetX() < Max.GetX() && Point.GetY() < Max.GetY();
         }
+
+        constexpr bool operator==(const Range2D& Rhs) const = default;
     };
     constexpr Range2D EmptyRange2D = {{std::numeric_limits<float>::max(), std::numeric_limits<float>::max()}, {std::numeric_limits<float>::min(), std::numeric_limits<float>::min()}};
 
@@ -107,6 +110,7 @@ namespace Plotter
         constexpr explicit ColorRGB(uint8_t r,uint8_t g,uint8_t b)
             : R(r), G(g), B(b)
         {}
+        constexpr bool operator==(const ColorRGB& Rhs) const = default;
     };
 
     constexpr ColorRGB Black(0,0,0);
@@ -176,6 +180,7 @@ namespace Plotter
             Points.emplace_back(x,y);
             PointMetaTags.push_back(MetaDataTag);
             Extents.Update(x,y);
+            ++DataVersion;
         }
 
         void AddPoint(const Algebra::Vector2D& Point, MetaDataTagType MetaDataTag = NullMetaDataTag)
@@ -183,6 +188,7 @@ namespace Plotter
             Points.emplace_back(Point);
             PointMetaTags.push_back(MetaDataTag);
             Extents.Update(Point.GetX(), Point.GetY());
+            ++DataVersion;
         }
 
         
@@ -292,29 +298,58 @@ namespace Plotter
             return end();
         }
 
-        std::pair<Iterator, float> FindNearest(const Algebra::Vector2D& Point) const
+        /**
+         * @brief The point nearest to Point and its squared distance, the first such point if several are as near.
+         *
+         * Sweeps outwards from Point's x in the points' x order, which is kept in an index built on the first search
+         * after points were added, O(log n) for a trajectory. Not to be called from several threads at once.
+         */
+        std::pair<Iterator, float> FindNearest(const Algebra::Vector2D& Point) const;
+
+        static void GetPointInfo(const Iterator& Iter, PointInfo& OutPointInfo);
+
+    private:
+        /**
+         * @brief The curve's splined viewport points as last rendered, reused for as long as the points, the plot's
+         * extents and the viewport window are unchanged.
+         */
+        struct TessellationCache
         {
-            float MinDistanceSq = std::numeric_limits<float>::max();
-            size_t MinIndex = 0;
-            for (size_t nT = 0; nT < Points.size(); nT++)
+            // the curve's DataVersion starts at 0 and is bumped by every point, so a new cache never matches a curve with points
+            uint64_t DataVersion = 0;
+            Range2D DataExtents = EmptyRange2D;
+            Range2D ViewportExtents = EmptyRange2D;
+            // the splined points, drawn as a polyline with a marker at each
+            std::vector<Algebra::Vector2D> Points;
+
+            bool IsValidFor(uint64_t InDataVersion, const Range2D& InDataExtents, const Range2D& InViewportExtents) const
             {
-                const float DistanceSq = (Point - Points[nT]).LengthSq();
-                if (DistanceSq < MinDistanceSq)
-                {
-                    MinDistanceSq = DistanceSq;
-                    MinIndex = nT;
-                }
+                return DataVersion == InDataVersion && DataExtents == InDataExtents && ViewportExtents == InViewportExtents;
             }
-            return {{Points, PointMetaTags, MinIndex}, MinDistanceSq};
-        }
+        };
 
-        static void GetPointInfo(const Iterator& Iter, PointInfo& OutPointInfo);
+        /**
+         * @brief The points' x order for FindNearest, as of DataVersion.
+         */
+        struct NearestIndex
+        {
+            uint64_t DataVersion = 0;
+            // the points' x in increasing order
+            std::vector<float> SortedX;
+            // the point at each SortedX, empty while the points are in x order already, as a trajectory's are
+            std::vector<uint32_t> SortedPoint;
+        };
+
+        // bring Nearest up to date, appending while points keep coming in x order and sorting otherwise
+        void UpdateNearestIndex() const;
 
-    private:
         std::vector<Algebra::Vector2D> Points;
         std::vector<MetaDataTagType> PointMetaTags;
         Range2D Extents;
         ColorRGB Color;
+        uint64_t DataVersion = 0;
+        TessellationCache Tessellation;
+        mutable NearestIndex Nearest;
         friend class Plot;
         friend class Renderer::PlotRenderer;
     };
@@ -429,6 +464,9 @@ namespace Plotter
      * - Rendering 2D lines with specified coordinates and color.
      * - Rendering textual elements at a given position with a specific color.
      * - Retrieving the extent of the current rendering viewport.
+     *
+     * The batch primitives submit many elements of one color in a single call. They default to DrawLine per
+     * element, a renderer should override them with its native batched calls.
      */
     struct IRenderer
     {
@@ -436,6 +474,15 @@ namespace Plotter
         virtual void DrawLine(float x0, float y0, float x1, float y1, ColorRGB Color) = 0;
         virtual void DrawText(const std::string& Text, const Algebra::Vector2D& Position, ColorRGB Color) = 0;
         virtual Range2D GetViewportExtents() = 0;
+
+        // separate segments
+        virtual void DrawLines(std::span<const Line2D> Lines, ColorRGB Color);
+        // connected segments through all of the points
+        virtual void DrawPolyline(std::span<const Algebra::Vector2D> Points, ColorRGB Color);
+        virtual void DrawPoints(std::span<const Algebra::Vector2D> Points, ColorRGB Color);
+        virtual void FillRect(const Range2D& Rect, ColorRGB Color);
+        // a disc of Radius around each of the centers, e.g. point markers
+        virtual void FillCircles(std::span<const Algebra::Vector2D> Centers, float Radius, ColorRGB Color);
     };
     using RendererPtr = std::shared_ptr<IRenderer>;
     void SetRenderer(RendererPtr InRenderer);
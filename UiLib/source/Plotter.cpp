@@ -1,5 +1,6 @@
 ﻿#include "Plotter.h"
 #include <cassert>
+#include <numeric>
 #include "Curves.h"
 
 namespace 
@@ -17,6 +18,9 @@ namespace Plotter
     LineBufferType LineBuffer;
     TextBufferType TextBuffer;
     PlotBufferType PlotBuffer;
+    // scratch for SubmitLines
+    std::vector<Line2D> LineBatch;
+    constexpr float CurveMarkerRadius = 2.0f;
 
     struct ViewportTransform
     {
@@ -62,6 +66,100 @@ namespace Plotter
         OutPoint.SetY( ((ViewportExtents.Min.GetY() + ViewportExtents.Max.GetY()) - Point.GetY() - Transform.Translation.GetY())/Transform.Scale.GetY() ); 
     }
     
+    /**
+     * Submit each run of lines of one color as a single DrawLines
+     * @param Transform if not null, the lines are in plot space and transformed to the viewport first
+     */
+    void SubmitLines(const LineBufferType& Lines, const ViewportTransform* Transform, const Range2D& ViewportExtents)
+    {
+        for (size_t Begin = 0; Begin < Lines.size();)
+        {
+            const ColorRGB Color = Lines[Begin].second;
+            LineBatch.clear();
+            size_t End = Begin;
+            for (; End < Lines.size() && Lines[End].second == Color; ++End)
+            {
+                if (Transform)
+                {
+                    ToViewport(*Transform, ViewportExtents, Lines[End].first, LineBatch.emplace_back());
+                }
+                else
+                {
+                    LineBatch.push_back(Lines[End].first);
+                }
+            }
+            RendererImpl->DrawLines(LineBatch, Color);
+            Begin = End;
+        }
+    }
+
+    void IRenderer::DrawLines(std::span<const Line2D> Lines, ColorRGB Color)
+    {
+        for (const Line2D& Line : Lines)
+        {
+            DrawLine(Line.Start.GetX(), Line.Start.GetY(), Line.End.GetX(), Line.End.GetY(), Color);
+        }
+    }
+
+    void IRenderer::DrawPolyline(std::span<const Algebra::Vector2D> Points, ColorRGB Color)
+    {
+        for (size_t n = 1; n < Points.size(); ++n)
+        {
+            DrawLine(Points[n-1].GetX(), Points[n-1].GetY(), Points[n].GetX(), Points[n].GetY(), Color);
+        }
+    }
+
+    void IRenderer::DrawPoints(std::span<const Algebra::Vector2D> Points, ColorRGB Color)
+    {
+        for (const Algebra::Vector2D& Point : Points)
+        {
+            DrawLine(Point.GetX(), Point.GetY(), Point.GetX(), Point.GetY(), Color);
+        }
+    }
+
+    void IRenderer::FillRect(const Range2D& Rect, ColorRGB Color)
+    {
+        for (float y = Rect.Min.GetY(); y < Rect.Max.GetY(); y += 1.0f)
+        {
+            DrawLine(Rect.Min.GetX(), y, Rect.Max.GetX(), y, Color);
+        }
+    }
+
+    void IRenderer::FillCircles(std::span<const Algebra::Vector2D> Centers, float Radius, ColorRGB Color)
+    {
+        for (const Algebra::Vector2D& Center : Centers)
+        {
+            const float centerX = Center.GetX();
+            const float centerY = Center.GetY();
+            // Using the midpoint circle algorithm
+            const float diameter = Radius * 2;
+            float x = Radius - 1;
+            float y = 0;
+            float dx = 1;
+            float dy = 1;
+            float error = dx - diameter;
+
+            while (x >= y) {
+                // Draw horizontal lines for each quadrant to fill the circle
+                DrawLine(centerX - x, centerY + y, centerX + x, centerY + y, Color);
+                DrawLine(centerX - x, centerY - y, centerX + x, centerY - y, Color);
+                DrawLine(centerX - y, centerY + x, centerX + y, centerY + x, Color);
+                DrawLine(centerX - y, centerY - x, centerX + y, centerY - x, Color);
+
+                if (error <= 0) {
+                    y++;
+                    error += dy;
+                    dy += 2;
+                }
+                if (error > 0) {
+                    x--;
+                    dx += 2;
+                    error += dx - diameter;
+                }
+            }
+        }
+    }
+
     void DrawPlot(PlotPtr InPlot, const Range2D& ViewportWindow)
     {
         PlotBuffer.emplace_back(InPlot, ViewportWindow);
@@ -109,6 +207,93 @@ namespace Plotter
         OutPointInfo.Tangent = Segment.Tangent(SampleT);
     }
 
+    void Curve2D::UpdateNearestIndex() const
+    {
+        // points are only ever appended, so a sorted prefix stays valid
+        if (!Nearest.SortedPoint.empty() || Nearest.SortedX.size() > Points.size())
+        {
+            Nearest.SortedX.clear();
+            Nearest.SortedPoint.clear();
+        }
+        bool bInOrder = true;
+        for (size_t n = Nearest.SortedX.size(); n < Points.size() && bInOrder; ++n)
+        {
+            bInOrder = Nearest.SortedX.empty() || Nearest.SortedX.back() <= Points[n].GetX();
+            if (bInOrder)
+            {
+                Nearest.SortedX.push_back(Points[n].GetX());
+            }
+        }
+        if (!bInOrder)
+        {
+            Nearest.SortedPoint.resize(Points.size());
+            std::iota(Nearest.SortedPoint.begin(), Nearest.SortedPoint.end(), 0u);
+            std::stable_sort(Nearest.SortedPoint.begin(), Nearest.SortedPoint.end(), [this](uint32_t Lhs, uint32_t Rhs)
+                {
+                    return Points[Lhs].GetX() < Points[Rhs].GetX();
+                });
+            Nearest.SortedX.resize(Points.size());
+            for (size_t n = 0; n < Points.size(); ++n)
+            {
+                Nearest.SortedX[n] = Points[Nearest.SortedPoint[n]].GetX();
+            }
+        }
+        Nearest.DataVersion = DataVersion;
+    }
+
+    std::pair<Curve2D::Iterator, float> Curve2D::FindNearest(const Algebra::Vector2D& Point) const
+    {
+        if (Nearest.DataVersion != DataVersion)
+        {
+            UpdateNearestIndex();
+        }
+        const std::vector<float>& SortedX = Nearest.SortedX;
+        float MinDistanceSq = std::numeric_limits<float>::max();
+        size_t MinIndex = 0;
+        const auto Visit = [&](size_t nSorted)
+            {
+                const size_t nT = Nearest.SortedPoint.empty() ? nSorted : Nearest.SortedPoint[nSorted];
+                const float DistanceSq = (Point - Points[nT]).LengthSq();
+                if (DistanceSq < MinDistanceSq || (DistanceSq == MinDistanceSq && nT < MinIndex))
+                {
+                    MinDistanceSq = DistanceSq;
+                    MinIndex = nT;
+                }
+            };
+
+        // a point further in x alone than the nearest so far can't be nearer, nor can any beyond it
+        size_t Right = static_cast<size_t>(std::lower_bound(SortedX.begin(), SortedX.end(), Point.GetX()) - SortedX.begin());
+        size_t Left = Right;
+        while (Right < SortedX.size() || Left > 0)
+        {
+            if (Right < SortedX.size())
+            {
+                const float DistanceX = SortedX[Right] - Point.GetX();
+                if (DistanceX * DistanceX > MinDistanceSq)
+                {
+                    Right = SortedX.size();
+                }
+                else
+                {
+                    Visit(Right++);
+                }
+            }
+            if (Left > 0)
+            {
+                const float DistanceX = Point.GetX() - SortedX[Left - 1];
+                if (DistanceX * DistanceX > MinDistanceSq)
+                {
+                    Left = 0;
+                }
+                else
+                {
+                    Visit(--Left);
+                }
+            }
+        }
+        return {{Points, PointMetaTags, MinIndex}, MinDistanceSq};
+    }
+
     std::optional<Curve2D::Iterator> Plot::FindNearest(const Algebra::Vector2D& Point, MetaDataTagType MetaDataTagFilter) const
     {
         Curve2D::Iterator Iter;
@@ -186,48 +371,6 @@ namespace Plotter
 using namespace Plotter;
 namespace Renderer
 {
-    static void RenderFilledCircle(float centerX, float centerY, float radius, ColorRGB color)
-    {
-        // Using the midpoint circle algorithm
-        const float diameter = radius * 2;
-        float x = radius - 1;
-        float y = 0;
-        float dx = 1;
-        float dy = 1;
-        float error = dx - diameter;
-
-        while (x >= y) {
-            // Draw horizontal lines for each quadrant to fill the circle
-            RendererImpl->DrawLine( 
-                centerX - x, centerY + y, 
-                centerX + x, centerY + y,
-                color);
-            RendererImpl->DrawLine( 
-                centerX - x, centerY - y, 
-                centerX + x, centerY - y,
-                color);
-            RendererImpl->DrawLine( 
-                centerX - y, centerY + x, 
-                centerX + y, centerY + x,
-                color);
-            RendererImpl->DrawLine( 
-                centerX - y, centerY - x, 
-                centerX + y, centerY - x,
-                color);
-
-            if (error <= 0) {
-                y++;
-                error += dy;
-                dy += 2;
-            }
-            if (error > 0) {
-                x--;
-                dx += 2;
-                error += dx - diameter;
-            }
-        }
-    }
-
     class PlotRenderer
     {
     public:
@@ -238,50 +381,22 @@ namespace Renderer
                 ViewportTransform Transform;
                 Range2D ViewportWindowExtents = Plot.second.IsEmpty() ? RendererImpl->GetViewportExtents() : Plot.second;
                 GenerateTransform(Plot.first->GetExtents(), ViewportWindowExtents, Transform);
-                for (const auto & Curve : Plot.first->Curves)
+                for (auto & Curve : Plot.first->Curves)
                 {
-                    std::vector<Algebra::Vector2D> TransformedPoints;
-                    ToViewport(Transform, ViewportWindowExtents, Curve.Points, TransformedPoints);
-
-                    RendererImpl->DrawLine(
-                                           TransformedPoints[0].GetX(),
-                                           TransformedPoints[0].GetY(),
-                                           TransformedPoints[1].GetX(),
-                                           TransformedPoints[1].GetY(),
-                                           Curve.Color);
-                    RenderFilledCircle(TransformedPoints[0].GetX(), TransformedPoints[0].GetY(), 2.0f, Curve.Color);
-                    RenderFilledCircle(TransformedPoints[1].GetX(), TransformedPoints[1].GetY(), 2.0f, Curve.Color);
-                    
-                    std::vector<Algebra::Vector2D> SampledPoints;
-                    for (size_t n = 1; n < TransformedPoints.size()-2; ++n)
+                    // only splined again when points were added or the plot or the window were resized
+                    Curve2D::TessellationCache& Cache = Curve.Tessellation;
+                    if (!Cache.IsValidFor(Curve.DataVersion, Plot.first->GetExtents(), ViewportWindowExtents))
                     {
-                        Curves::CatmullRomSegment2D SampleCurve(TransformedPoints[n-1], TransformedPoints[n], TransformedPoints[n+1], TransformedPoints[n+2]);
-                        SampleCurve.SampleAdaptively(SampledPoints, 0.0f, 1.0f, 0.10f);
-                        for (size_t nQ = 0; nQ < SampledPoints.size(); nQ+=2)
-                        {
-                            RendererImpl->DrawLine(
-                                           SampledPoints[nQ+0].GetX(),
-                                           SampledPoints[nQ+0].GetY(),
-                                           SampledPoints[nQ+1].GetX(),
-                                           SampledPoints[nQ+1].GetY(),
-                                           Curve.Color);
-                            RenderFilledCircle(SampledPoints[nQ+1].GetX(), SampledPoints[nQ+1].GetY(), 2.0f, Curve.Color);
-                        }
-                        SampledPoints.clear();
+                        TessellateCurve(Curve, Transform, ViewportWindowExtents, Cache.Points);
+                        Cache.DataVersion = Curve.DataVersion;
+                        Cache.DataExtents = Plot.first->GetExtents();
+                        Cache.ViewportExtents = ViewportWindowExtents;
                     }
+                    RendererImpl->DrawPolyline(Cache.Points, Curve.Color);
+                    RendererImpl->FillCircles(Cache.Points, CurveMarkerRadius, Curve.Color);
                 }
                 
-                for (const auto & Line : Plot.first->Lines)
-                {
-                    Line2D TransformedLine;
-                    ToViewport(Transform, ViewportWindowExtents, Line.first, TransformedLine);
-                    RendererImpl->DrawLine(
-                        TransformedLine.Start.GetX(),
-                        TransformedLine.Start.GetY(),
-                        TransformedLine.End.GetX(),
-                        TransformedLine.End.GetY(),
-                        Line.second);
-                }
+                SubmitLines(Plot.first->Lines, &Transform, ViewportWindowExtents);
 
                 for (const auto & Label : Plot.first->Labels)
                 {
@@ -299,22 +414,43 @@ namespace Renderer
                         RendererImpl->DrawText(Label.first.String, TransformedLabelPosition, Label.second);
                     }
 
-                    for (const auto& Line : Plot.first->TransientElements.Lines)
-                    {
-                        Line2D TransformedLine;
-                        ToViewport(Transform, ViewportWindowExtents, Line.first, TransformedLine);
-                        RendererImpl->DrawLine(
-                            TransformedLine.Start.GetX(),
-                            TransformedLine.Start.GetY(),
-                            TransformedLine.End.GetX(),
-                            TransformedLine.End.GetY(),
-                            Line.second);
-                    }
+                    SubmitLines(Plot.first->TransientElements.Lines, &Transform, ViewportWindowExtents);
 
                     Plot.first->TransientElements.Clear();
                 }
             }
         }
+
+    private:
+        /**
+         * Spline the curve's viewport points, the segments join up so that they are one polyline
+         * @param OutPoints replaced with the polyline's points in viewport coordinates
+         */
+        static void TessellateCurve(const Curve2D& Curve, const ViewportTransform& Transform, const Range2D& ViewportWindowExtents, std::vector<Algebra::Vector2D>& OutPoints)
+        {
+            OutPoints.clear();
+            if (Curve.Points.size() < 2)
+            {
+                return;
+            }
+            std::vector<Algebra::Vector2D> TransformedPoints;
+            ToViewport(Transform, ViewportWindowExtents, Curve.Points, TransformedPoints);
+
+            OutPoints.push_back(TransformedPoints[0]);
+            OutPoints.push_back(TransformedPoints[1]);
+            std::vector<Algebra::Vector2D> SampledPoints;
+            for (size_t n = 1; n < TransformedPoints.size()-2; ++n)
+            {
+                Curves::CatmullRomSegment2D SampleCurve(TransformedPoints[n-1], TransformedPoints[n], TransformedPoints[n+1], TransformedPoints[n+2]);
+                SampleCurve.SampleAdaptively(SampledPoints, 0.0f, 1.0f, 0.10f);
+                // samples come as start and end pairs, each start is the previous end
+                for (size_t nQ = 1; nQ < SampledPoints.size(); nQ+=2)
+                {
+                    OutPoints.push_back(SampledPoints[nQ]);
+                }
+                SampledPoints.clear();
+            }
+        }
     };
 }
 
@@ -337,10 +473,7 @@ namespace Plotter
         assert(bInFrame);
         Renderer::PlotRenderer::RenderPlots();
 
-        for (const auto & Line : LineBuffer)
-        {
-            RendererImpl->DrawLine(Line.first.Start.GetX(), Line.first.Start.GetY(), Line.first.End.GetX(), Line.first.End.GetY(), Line.second);
-        }
+        SubmitLines(LineBuffer, nullptr, RendererImpl->GetViewportExtents());
 
         for (const auto & Text : TextBuffer)
         {